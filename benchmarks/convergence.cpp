@@ -0,0 +1,84 @@
+#include "../src/kuhn_poker.h"
+#include "../src/mccfr.h"
+#include "../src/lcfr.h"
+#include "../src/best_response.h"
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <string>
+
+/*
+    Runs every solver on two and three player Kuhn poker and writes the exploitability of its
+    average strategy as a function of the iterations and the time spent training, as CSV. The
+    strategy is measured at 1, 2, 5, 10, 20, 50, ... iterations, until the time limit of the run
+    is spent. Calculating the strategy and its exploitability is not counted as training time.
+
+    Usage: pluribus_convergence [seconds per run] [output file]
+    The output is written to standard output when no file is given.
+*/
+
+namespace {
+
+    typedef robin_hood::unordered_map<uint64_t, robin_hood::unordered_map<Move, float>> Strategy;
+
+    int next_measurement(int iterations) {
+        // 1, 2, 5, 10, 20, 50, ...
+        int scale = 1;
+        while (iterations >= 10 * scale)
+            scale *= 10;
+        int step = iterations / scale;
+        return (step < 2 ? 2 : (step < 5 ? 5 : 10)) * scale;
+    }
+
+    void run(std::ostream& output, std::string solver, Game& game, double seconds, std::function<uint64_t(int, int)> train, std::function<Strategy()> calculate_strategy) {
+        // train runs the iterations from the first up to the last, and returns the number of nodes visited so far.
+        random_engine.seed(42);
+        game.reset_game();
+        std::chrono::duration<double> training_time{0.0};
+        int iterations = 0;
+        while (training_time.count() < seconds) {
+            int measurement = iterations == 0 ? 1 : next_measurement(iterations);
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            uint64_t nodes = train(iterations, measurement);
+            training_time += std::chrono::steady_clock::now() - start;
+            iterations = measurement;
+
+            Strategy strategy = calculate_strategy();
+            Exploitability exploitability = best_response::calculate_exploitability(game, strategy);
+            output << solver << "," << game.get_num_players() << "," << iterations << "," << training_time.count() << "," << nodes << "," << exploitability.exploitability << std::endl;
+        }
+    }
+
+}
+
+int main(int argc, char* argv[]) {
+    double seconds = argc > 1 ? std::stod(argv[1]) : 10.0;
+    std::ofstream file;
+    if (argc > 2)
+        file.open(argv[2]);
+    std::ostream& output = argc > 2 ? file : std::cout;
+
+    output << "solver,players,iterations,seconds,nodes,exploitability" << std::endl;
+    for (int players:{2, 3}) {
+        KuhnPoker kuhn_poker(players);
+
+        // The parameters of the two player MCCFR test.
+        MCCFR mccfr(RegretStorage::HASH_MAP, 42);
+        run(output, "mccfr", kuhn_poker, seconds, [&](int first_timestep, int timesteps) {
+            mccfr.train(first_timestep, timesteps, 1, 20000, 1000, 20, kuhn_poker, nullptr, 0);
+            return mccfr.nodes_visited;
+        }, [&]() {
+            return mccfr.calculate_probabilities(kuhn_poker);
+        });
+
+        LCFR lcfr(RegretStorage::HASH_MAP, 42);
+        run(output, "lcfr", kuhn_poker, seconds, [&](int first_timestep, int timesteps) {
+            lcfr.train(first_timestep, timesteps, kuhn_poker, cfr_variants::linear(), nullptr, 0);
+            return lcfr.nodes_visited;
+        }, [&]() {
+            return lcfr.calculate_cumulative_strategy(kuhn_poker);
+        });
+    }
+    return 0;
+}
@@ -0,0 +1,115 @@
+#include "benchmark/benchmark.h"
+#include "../src/calculations.h"
+#include "../src/holdem.h"
+#include "../src/kuhn_poker.h"
+#include "../src/mccfr.h"
+#include "../src/lcfr.h"
+#include "../src/rng.h"
+#include <vector>
+
+/*
+    Microbenchmarks of the paths that the solvers depend on. Every benchmark seeds its random
+    engine, so two runs measure the same work. Run with --benchmark_out=<file> and
+    --benchmark_out_format=json to keep the results for comparing runs.
+*/
+
+namespace {
+
+    std::vector<unsigned long long> random_hands(int num_hands, int num_cards) {
+        // The hands are masks of num_cards distinct cards out of 52.
+        Rng rng(42);
+        std::vector<unsigned long long> hands(num_hands, 0ULL);
+        for (unsigned long long& hand:hands)
+            while (__builtin_popcountll(hand) < num_cards)
+                hand |= 1ULL << (rng() % 52);
+        return hands;
+    }
+
+}
+
+static void BM_CalculateHandStrength(benchmark::State& state) {
+    std::vector<unsigned long long> hands = random_hands(1024, 7);
+    for (auto _ : state)
+        for (unsigned long long hand:hands)
+            benchmark::DoNotOptimize(Holdem::CalculateHandStrength(hand));
+    state.SetItemsProcessed(state.iterations() * hands.size());
+}
+BENCHMARK(BM_CalculateHandStrength);
+
+static void BM_CompressHandLossless(benchmark::State& state) {
+    std::vector<unsigned long long> hands = random_hands(1024, state.range(0));
+    for (auto _ : state)
+        for (unsigned long long hand:hands)
+            benchmark::DoNotOptimize(compress_hand_lossless(hand));
+    state.SetItemsProcessed(state.iterations() * hands.size());
+}
+BENCHMARK(BM_CompressHandLossless)->Arg(2)->Arg(7);
+
+static void BM_HeadsupOutcomes(benchmark::State& state) {
+    // The player holds the two lowest cards of a random hand, and the rest is the board.
+    unsigned long long hand = random_hands(1, 2 + state.range(0))[0];
+    unsigned long long first_card = hand & (~hand + 1);
+    unsigned long long second_card = (hand ^ first_card) & (~(hand ^ first_card) + 1);
+    unsigned long long player_cards = first_card | second_card;
+    unsigned long long board_cards = hand & ~player_cards;
+    for (auto _ : state)
+        benchmark::DoNotOptimize(calculations::headsup_outcomes(player_cards, board_cards));
+}
+BENCHMARK(BM_HeadsupOutcomes)->Arg(5)->Arg(4)->Arg(3)->Unit(benchmark::kMillisecond);
+
+static void BM_KuhnPokerExecuteUndo(benchmark::State& state) {
+    // Plays the first action until the hand is finished, and undoes the hand again.
+    random_engine.seed(42);
+    KuhnPoker kuhn_poker(state.range(0));
+    Game& game = kuhn_poker;
+    std::vector<Move> actions;
+    actions.reserve(MAX_MOVES);
+    int64_t moves = 0;
+    for (auto _ : state) {
+        int depth = 0;
+        while (!game.is_finished()) {
+            actions.clear();
+            game.get_actions(actions);
+            game.execute(actions[0]);
+            ++depth;
+        }
+        for (int x=0; x<depth; ++x)
+            game.undo();
+        moves += depth;
+    }
+    state.SetItemsProcessed(moves);
+}
+BENCHMARK(BM_KuhnPokerExecuteUndo)->Arg(2)->Arg(3);
+
+static void BM_TraverseMCCFR(benchmark::State& state) {
+    random_engine.seed(42);
+    KuhnPoker kuhn_poker(state.range(0));
+    Game& game = kuhn_poker;
+    MCCFR solver(RegretStorage::HASH_MAP, 42);
+    int player = 0;
+    for (auto _ : state) {
+        game.reset_game(solver.rng);
+        benchmark::DoNotOptimize(solver.traverse_mccfr(game, solver.get_root(), player, false));
+        player = (player + 1) % game.get_num_players();
+    }
+    state.counters["nodes/s"] = benchmark::Counter(static_cast<double>(solver.nodes_visited), benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_TraverseMCCFR)->Arg(2)->Arg(3);
+
+static void BM_LCFRSearch(benchmark::State& state) {
+    // Every benchmark iteration is one LCFR iteration, a traversal for every player. The timestep
+    // goes on from one iteration to the next, as it does in a real run.
+    random_engine.seed(42);
+    KuhnPoker kuhn_poker(state.range(0));
+    LCFR solver(RegretStorage::HASH_MAP, 42);
+    int timestep = 0;
+    for (auto _ : state) {
+        solver.train(timestep, timestep + 1, kuhn_poker, cfr_variants::linear(), nullptr, 0);
+        ++timestep;
+    }
+    state.counters["iterations/s"] = benchmark::Counter(static_cast<double>(state.iterations()), benchmark::Counter::kIsRate);
+    state.counters["nodes/s"] = benchmark::Counter(static_cast<double>(solver.nodes_visited), benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_LCFRSearch)->Arg(2)->Arg(3);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,39 @@
+#include "action_abstraction.h"
+#include <algorithm>
+#include <cmath>
+
+ActionAbstraction::ActionAbstraction() : ActionAbstraction({{{1.0f}}, {{1.0f}}, {{1.0f}}, {{1.0f}}}) {}
+
+ActionAbstraction::ActionAbstraction(std::vector<std::vector<std::vector<float>>> raise_sizes) : raise_sizes{raise_sizes} {
+    for (std::vector<std::vector<float>>& round_raise_sizes:this->raise_sizes) {
+        assertm(!round_raise_sizes.empty(), "Every round has a menu.");
+        for (std::vector<float>& menu:round_raise_sizes)
+            assertm(std::is_sorted(menu.begin(), menu.end()), "The raise sizes are increasing.");
+    }
+}
+
+void ActionAbstraction::set_raise_sizes(int round, int num_raises, std::vector<float> menu) {
+    assertm(std::is_sorted(menu.begin(), menu.end()), "The raise sizes are increasing.");
+    if (raise_sizes[round].size() <= num_raises)
+        raise_sizes[round].resize(num_raises + 1, raise_sizes[round].back());
+    raise_sizes[round][num_raises] = menu;
+}
+
+const std::vector<float>& ActionAbstraction::get_raise_sizes(int round, int num_raises) {
+    std::vector<std::vector<float>>& round_raise_sizes = raise_sizes[round];
+    return round_raise_sizes[std::min(num_raises, static_cast<int>(round_raise_sizes.size()) - 1)];
+}
+
+int ActionAbstraction::get_max_actions() {
+    // Fold, check/call and the largest menu.
+    size_t max_raise_sizes = 0;
+    for (std::vector<std::vector<float>>& round_raise_sizes:raise_sizes)
+        for (std::vector<float>& menu:round_raise_sizes)
+            max_raise_sizes = std::max(max_raise_sizes, menu.size());
+    return 2 + max_raise_sizes;
+}
+
+float ActionAbstraction::get_lower_probability(float lower, float upper, float size) {
+    // The probability of translating the size to the lower of the two sizes around it, all as pot fractions.
+    return ((upper - size) * (1.0f + lower)) / ((upper - lower) * (1.0f + size));
+}
@@ -0,0 +1,32 @@
+#ifndef ACTION_ABSTRACTION_H
+#define ACTION_ABSTRACTION_H
+
+#include <limits>
+#include <vector>
+#include "game.h"
+
+class ActionAbstraction {
+    /*
+        The raise sizes that are available in each betting round, depending on how many raises
+        there have already been in the round. A raise size is a fraction of the pot after calling,
+        and ALL_IN puts in the whole stack. When a round has no menu for the number of raises, the
+        menu for the most raises that is given is used. The n-th size of a menu is the move R + n.
+
+        Bets that are not in the abstraction are translated to one of the two closest sizes with
+        the pseudo-harmonic mapping (https://www.ijcai.org/Proceedings/13/Papers/021.pdf).
+    */
+    public:
+        static constexpr float ALL_IN = std::numeric_limits<float>::infinity();
+
+        ActionAbstraction();
+        ActionAbstraction(std::vector<std::vector<std::vector<float>>>);
+        void set_raise_sizes(int, int, std::vector<float>);
+        const std::vector<float>& get_raise_sizes(int, int);
+        int get_max_actions();
+        static float get_lower_probability(float, float, float);
+
+    private:
+        std::vector<std::vector<std::vector<float>>> raise_sizes;
+};
+
+#endif
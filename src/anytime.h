@@ -0,0 +1,84 @@
+#ifndef ANYTIME_H
+#define ANYTIME_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include "game.h"
+#include "../lib/robin_hood.h"
+
+class CancellationToken {
+    // Cancelled from any thread to stop the searches that were given the token.
+    public:
+        void cancel() {
+            cancelled.store(true, std::memory_order_relaxed);
+        }
+
+        bool is_cancelled() const {
+            return cancelled.load(std::memory_order_relaxed);
+        }
+
+        void reset() {
+            cancelled.store(false, std::memory_order_relaxed);
+        }
+
+    private:
+        std::atomic<bool> cancelled{false};
+};
+
+struct SearchBudget {
+    /*
+        An anytime search stops at the deadline, when the token is cancelled or after the maximum
+        number of iterations, whichever comes first. The budget is checked between iterations, so
+        a search overruns the deadline by at most one iteration.
+    */
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+    const CancellationToken* token = nullptr;
+    int max_iterations = std::numeric_limits<int>::max();
+
+    static SearchBudget for_duration(std::chrono::steady_clock::duration duration) {
+        SearchBudget budget;
+        budget.deadline = std::chrono::steady_clock::now() + duration;
+        return budget;
+    }
+
+    inline bool is_exhausted(int iterations) const {
+        return iterations >= max_iterations || (token != nullptr && token->is_cancelled()) || std::chrono::steady_clock::now() >= deadline;
+    }
+};
+
+struct SearchStatistics {
+    int iterations;
+    uint64_t nodes;
+    double seconds;
+
+    double get_nodes_per_second() const {
+        return seconds > 0.0 ? static_cast<double>(nodes) / seconds : 0.0;
+    }
+};
+
+struct AnytimeResult {
+    robin_hood::unordered_map<uint64_t, robin_hood::unordered_map<Move, float>> strategy;
+    SearchStatistics statistics;
+};
+
+namespace anytime {
+
+    template <typename Iteration>
+    SearchStatistics run(const SearchBudget& budget, uint64_t& nodes_visited, Iteration iteration) {
+        // Runs iterations until the budget is exhausted. The nodes are counted by the solver.
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        uint64_t first_nodes_visited = nodes_visited;
+        int iterations = 0;
+        while (!budget.is_exhausted(iterations)) {
+            iteration(iterations);
+            ++iterations;
+        }
+        std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - start;
+        return SearchStatistics{iterations, nodes_visited - first_nodes_visited, seconds.count()};
+    }
+
+}
+
+#endif
@@ -0,0 +1,92 @@
+#include "best_response.h"
+#include <algorithm>
+#include <limits>
+
+
+namespace best_response {
+
+    void get_strategy(Game& game, int current_player, std::vector<Move>& actions, robin_hood::unordered_map<uint64_t, robin_hood::unordered_map<Move, float>>& strategy, std::array<Range, MAX_MOVES>& infoset_strategy) {
+        // Infosets that are missing from the strategy are played uniformly at random.
+        for (int card=0; card<game.get_num_private_states(); ++card) {
+            game.set_private_state(current_player, card);
+            auto infoset_probabilities = strategy.find(game.get_infoset(current_player));
+            for (int x=0; x<actions.size(); ++x) {
+                infoset_strategy[x][card] = 1.0f/static_cast<float>(actions.size());
+                if (infoset_probabilities == strategy.end())
+                    continue;
+                auto probability = infoset_probabilities->second.find(actions[x]);
+                infoset_strategy[x][card] = probability == infoset_probabilities->second.end() ? 0.0f : probability->second;
+            }
+        }
+    }
+
+    void best_response(Game& game, int player, robin_hood::unordered_map<uint64_t, robin_hood::unordered_map<Move, float>>& strategy, std::vector<int>& deals, std::vector<Range>& reach, Range& best_response_values, Range& strategy_values) {
+        /*
+            Calculates, for every private state of the player, the counterfactual value of a best
+            response and of the strategy itself against the strategy of the opponents. Both are
+            calculated in the same pass over the public tree.
+        */
+        if (game.is_finished()) {
+            public_tree::terminal_values(game, player, reach, deals, strategy_values);
+            best_response_values = strategy_values;
+            return;
+        } else if (game.is_chance_node()) {
+            // Only the deals of private states are enumerated, so a sampled chance outcome would
+            // give an estimate instead of the exact best response.
+            throw std::runtime_error("The best response is for games without chance nodes.");
+        }
+        int current_player = game.get_player_to_move();
+        std::vector<Move> actions;
+        actions.reserve(MAX_MOVES);
+        game.get_actions(actions);
+        assertm(actions.size() <= MAX_MOVES, "The strategy has room for the actions.");
+        std::array<Range, MAX_MOVES> infoset_strategy;
+        get_strategy(game, current_player, actions, strategy, infoset_strategy);
+
+        Range prior_reach = reach[current_player];
+        Range action_best_response_values, action_strategy_values;
+        best_response_values.fill(current_player == player ? std::numeric_limits<float>::lowest() : 0.0f);
+        strategy_values.fill(0.0f);
+        for (int x=0; x<actions.size(); ++x) {
+            for (int card=0; card<MAX_CARDS; ++card)
+                reach[current_player][card] = prior_reach[card] * infoset_strategy[x][card];
+            game.execute(actions[x]);
+            best_response(game, player, strategy, deals, reach, action_best_response_values, action_strategy_values);
+            game.undo();
+            for (int card=0; card<MAX_CARDS; ++card) {
+                if (current_player == player) {
+                    best_response_values[card] = std::max(best_response_values[card], action_best_response_values[card]);
+                    strategy_values[card] += infoset_strategy[x][card] * action_strategy_values[card];
+                } else {
+                    best_response_values[card] += action_best_response_values[card];
+                    strategy_values[card] += action_strategy_values[card];
+                }
+            }
+        }
+        reach[current_player] = prior_reach;
+    }
+
+    Exploitability calculate_exploitability(Game& game, robin_hood::unordered_map<uint64_t, robin_hood::unordered_map<Move, float>>& strategy) {
+        /*
+            The exploitability is the sum over the players of how much they gain by switching to a
+            best response (NashConv). It is zero exactly when the strategy is a Nash equilibrium.
+        */
+        assertm(game.get_num_private_states() <= MAX_CARDS, "A range has room for the private states.");
+        assertm(game.get_max_actions() <= MAX_MOVES, "The strategy has room for the actions.");
+        int num_players = game.get_num_players();
+        std::vector<int> deals = public_tree::enumerate_deals(game);
+        Exploitability exploitability{std::vector<float>(num_players, 0.0f), std::vector<float>(num_players, 0.0f), 0.0f};
+        for (int player=0; player<num_players; ++player) {
+            game.reset_game();
+            std::vector<Range> reach(num_players, public_tree::uniform_range(game));
+            Range best_response_values, strategy_values;
+            best_response(game, player, strategy, deals, reach, best_response_values, strategy_values);
+            for (int card=0; card<game.get_num_private_states(); ++card) {
+                exploitability.best_response_values[player] += best_response_values[card];
+                exploitability.strategy_values[player] += strategy_values[card];
+            }
+            exploitability.exploitability += exploitability.best_response_values[player] - exploitability.strategy_values[player];
+        }
+        return exploitability;
+    }
+}
@@ -0,0 +1,22 @@
+#ifndef BEST_RESPONSE_H
+#define BEST_RESPONSE_H
+
+#include <vector>
+#include "game.h"
+#include "public_tree.h"
+#include "../lib/robin_hood.h"
+
+struct Exploitability {
+    std::vector<float> best_response_values;
+    std::vector<float> strategy_values;
+    float exploitability;
+};
+
+namespace best_response {
+
+    void best_response(Game&, int, robin_hood::unordered_map<uint64_t, robin_hood::unordered_map<Move, float>>&, std::vector<int>&, std::vector<Range>&, Range&, Range&);
+    Exploitability calculate_exploitability(Game&, robin_hood::unordered_map<uint64_t, robin_hood::unordered_map<Move, float>>&);
+
+}
+
+#endif
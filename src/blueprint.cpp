@@ -0,0 +1,190 @@
+#include "blueprint.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace blueprint {
+
+    constexpr uint64_t MAGIC = 0x544e495250455542ULL;
+    constexpr uint32_t VERSION = 1;
+
+    // The sections of the file start at multiples of 8 bytes, so they can be read in place.
+    inline uint64_t align(uint64_t size) {
+        return (size + 7) & ~static_cast<uint64_t>(7);
+    }
+
+    inline uint64_t get_infosets_position() {
+        return align(sizeof(BlueprintHeader));
+    }
+
+    inline uint64_t get_offsets_position(const BlueprintHeader& header) {
+        return get_infosets_position() + header.num_infosets * sizeof(uint64_t);
+    }
+
+    inline uint64_t get_actions_position(const BlueprintHeader& header) {
+        return get_offsets_position(header) + (header.num_infosets + 1) * sizeof(uint64_t);
+    }
+
+    inline uint64_t get_probabilities_position(const BlueprintHeader& header) {
+        return align(get_actions_position(header) + header.num_probabilities);
+    }
+
+    inline uint64_t get_file_size(const BlueprintHeader& header) {
+        return align(get_probabilities_position(header) + header.num_probabilities * header.probability_bits / 8);
+    }
+
+    template <typename T>
+    inline void write_section(std::ofstream& ofs, const std::vector<T>& values) {
+        ofs.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+        ofs.write("\0\0\0\0\0\0\0", align(ofs.tellp()) - ofs.tellp());
+    }
+
+    template <typename T>
+    std::vector<T> quantize(const std::vector<float>& probabilities) {
+        // Probabilities are rounded to the nearest multiple of 1/max; invalid ones (from a zero sum) become zero.
+        float max = static_cast<float>(std::numeric_limits<T>::max());
+        std::vector<T> quantized(probabilities.size());
+        for (size_t x=0; x<probabilities.size(); ++x)
+            quantized[x] = probabilities[x] >= 0.0f ? static_cast<T>(std::lround(std::min(probabilities[x], 1.0f) * max)) : 0;
+        return quantized;
+    }
+
+    void write(std::string file_name, Game& game, std::string game_name, std::string abstraction, robin_hood::unordered_map<uint64_t, robin_hood::unordered_map<Move, float>>& strategy, int probability_bits) {
+        if (probability_bits != 8 && probability_bits != 16)
+            throw std::runtime_error("The probabilities are stored with 8 or 16 bits.");
+
+        BlueprintHeader header{};
+        header.magic = MAGIC;
+        header.version = VERSION;
+        header.probability_bits = probability_bits;
+        header.num_players = game.get_num_players();
+        header.num_private_states = game.get_num_private_states();
+        header.num_infosets = strategy.size();
+        game_name.copy(header.game, sizeof(header.game) - 1);
+        abstraction.copy(header.abstraction, sizeof(header.abstraction) - 1);
+
+        std::vector<uint64_t> infosets;
+        infosets.reserve(strategy.size());
+        for (auto const& [infoset, infoset_strategy]:strategy)
+            infosets.push_back(infoset);
+        std::sort(infosets.begin(), infosets.end());
+
+        std::vector<uint64_t> offsets{0};
+        std::vector<uint8_t> actions;
+        std::vector<float> probabilities;
+        for (uint64_t infoset:infosets) {
+            std::vector<std::pair<Move, float>> infoset_strategy;
+            for (auto const& [action, probability]:strategy[infoset])
+                infoset_strategy.emplace_back(action, probability);
+            std::sort(infoset_strategy.begin(), infoset_strategy.end());
+            for (auto const& [action, probability]:infoset_strategy) {
+                actions.push_back(static_cast<uint8_t>(action));
+                probabilities.push_back(probability);
+            }
+            offsets.push_back(actions.size());
+        }
+        header.num_probabilities = actions.size();
+
+        // The file is renamed into place once it is complete, so readers never map a partial file.
+        std::string tmp_file_name = file_name + ".tmp";
+        std::ofstream ofs(tmp_file_name, std::ios::binary | std::ios::trunc);
+        ofs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        ofs.write("\0\0\0\0\0\0\0", get_infosets_position() - sizeof(header));
+        write_section(ofs, infosets);
+        write_section(ofs, offsets);
+        write_section(ofs, actions);
+        if (probability_bits == 8)
+            write_section(ofs, quantize<uint8_t>(probabilities));
+        else
+            write_section(ofs, quantize<uint16_t>(probabilities));
+        ofs.close();
+        if (!ofs || std::rename(tmp_file_name.c_str(), file_name.c_str()) != 0)
+            throw std::runtime_error("Could not write the blueprint.");
+    }
+
+}
+
+Blueprint::Blueprint(std::string file_name) {
+    int fd = open(file_name.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw std::runtime_error("Could not open the blueprint.");
+    struct stat file_stat;
+    fstat(fd, &file_stat);
+    file_size = file_stat.st_size;
+    data = file_size >= sizeof(BlueprintHeader) ? mmap(nullptr, file_size, PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+    close(fd);
+    if (data == MAP_FAILED)
+        throw std::runtime_error("Could not map the blueprint.");
+
+    const char* bytes = static_cast<const char*>(data);
+    header = reinterpret_cast<const BlueprintHeader*>(bytes);
+    if (header->magic != blueprint::MAGIC || header->version != blueprint::VERSION || blueprint::get_file_size(*header) != file_size) {
+        munmap(data, file_size);
+        throw std::runtime_error("The file is not a blueprint of this version.");
+    }
+    infosets = reinterpret_cast<const uint64_t*>(bytes + blueprint::get_infosets_position());
+    offsets = reinterpret_cast<const uint64_t*>(bytes + blueprint::get_offsets_position(*header));
+    actions = reinterpret_cast<const uint8_t*>(bytes + blueprint::get_actions_position(*header));
+    probabilities = bytes + blueprint::get_probabilities_position(*header);
+}
+
+Blueprint::~Blueprint() {
+    munmap(data, file_size);
+}
+
+const BlueprintHeader& Blueprint::get_header() {
+    return *header;
+}
+
+uint64_t Blueprint::size() {
+    return header->num_infosets;
+}
+
+int64_t Blueprint::find(uint64_t infoset) {
+    const uint64_t* end = infosets + header->num_infosets;
+    const uint64_t* position = std::lower_bound(infosets, end, infoset);
+    return (position != end && *position == infoset) ? position - infosets : -1;
+}
+
+float Blueprint::decode(uint64_t index) {
+    if (header->probability_bits == 8)
+        return static_cast<const uint8_t*>(probabilities)[index] / static_cast<float>(UINT8_MAX);
+    return static_cast<const uint16_t*>(probabilities)[index] / static_cast<float>(UINT16_MAX);
+}
+
+bool Blueprint::contains(uint64_t infoset) {
+    return find(infoset) >= 0;
+}
+
+float Blueprint::get_probability(uint64_t infoset, Move action) {
+    int64_t index = find(infoset);
+    if (index < 0)
+        throw std::runtime_error("The infoset is not in the blueprint.");
+    for (uint64_t x=offsets[index]; x<offsets[index + 1]; ++x)
+        if (actions[x] == static_cast<uint8_t>(action))
+            return decode(x);
+    return 0.0f;
+}
+
+robin_hood::unordered_map<Move, float> Blueprint::get_strategy(uint64_t infoset) {
+    robin_hood::unordered_map<Move, float> strategy;
+    int64_t index = find(infoset);
+    if (index >= 0)
+        for (uint64_t x=offsets[index]; x<offsets[index + 1]; ++x)
+            strategy[static_cast<Move>(actions[x])] = decode(x);
+    return strategy;
+}
+
+robin_hood::unordered_map<uint64_t, robin_hood::unordered_map<Move, float>> Blueprint::get_strategy() {
+    robin_hood::unordered_map<uint64_t, robin_hood::unordered_map<Move, float>> strategy;
+    for (uint64_t index=0; index<header->num_infosets; ++index)
+        for (uint64_t x=offsets[index]; x<offsets[index + 1]; ++x)
+            strategy[infosets[index]][static_cast<Move>(actions[x])] = decode(x);
+    return strategy;
+}
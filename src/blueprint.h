@@ -0,0 +1,60 @@
+#ifndef BLUEPRINT_H
+#define BLUEPRINT_H
+
+#include <cstdint>
+#include <string>
+#include "game.h"
+#include "../lib/robin_hood.h"
+
+struct BlueprintHeader {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t probability_bits;
+    uint32_t num_players;
+    uint32_t num_private_states;
+    uint64_t num_infosets;
+    uint64_t num_probabilities;
+    char game[32];
+    char abstraction[32];
+};
+
+class Blueprint {
+    /*
+        A read-only strategy that is memory mapped from a blueprint file. The file is a header,
+        followed by the sorted infosets, the offset of every infoset into the actions, and the
+        actions with their quantized probabilities. Opening a blueprint only maps the file, and
+        processes that open the same file share its pages. An infoset is found by binary search.
+    */
+    public:
+        Blueprint(std::string);
+        ~Blueprint();
+        Blueprint(const Blueprint&) = delete;
+        Blueprint& operator=(const Blueprint&) = delete;
+
+        const BlueprintHeader& get_header();
+        uint64_t size();
+        bool contains(uint64_t);
+        float get_probability(uint64_t, Move);
+        robin_hood::unordered_map<Move, float> get_strategy(uint64_t);
+        robin_hood::unordered_map<uint64_t, robin_hood::unordered_map<Move, float>> get_strategy();
+
+    private:
+        void* data;
+        size_t file_size;
+        const BlueprintHeader* header;
+        const uint64_t* infosets;
+        const uint64_t* offsets;
+        const uint8_t* actions;
+        const void* probabilities;
+
+        int64_t find(uint64_t);
+        float decode(uint64_t);
+};
+
+namespace blueprint {
+
+    void write(std::string, Game&, std::string, std::string, robin_hood::unordered_map<uint64_t, robin_hood::unordered_map<Move, float>>&, int);
+
+}
+
+#endif
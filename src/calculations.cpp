@@ -38,55 +38,73 @@ unsigned long long compress_hand_lossless(unsigned long long hand) {
     return compressed_hand;
 }
 
-namespace calculations {
+void HandCalculator::load_suit_permutations() {
+    std::string file_name = "../../files/suit_permutations.txt";
+
+    if (!suit_permutations.empty())
+        return;
+
+    if (std::filesystem::exists(file_name)) {
+        std::ifstream ifs(file_name);
+        boost::archive::text_iarchive ia(ifs);
+        ia >> suit_permutations;
+        ifs.close();
+    } else {
+        for (int max_cards = 1; max_cards <= 7; ++max_cards)
+            calculations::calculate_suit_permutations(suit_permutations, 0ULL, 52, max_cards);
+        std::ofstream ofs(file_name);
+        boost::archive::text_oarchive oa(ofs);
+        oa << suit_permutations;
+        ofs.close();
+    }
+}
+
+int HandCalculator::num_suit_permutations(unsigned long long hand) {
+    if (suit_permutations.empty())
+        load_suit_permutations();
+
+    auto permutations = suit_permutations.find(compress_hand_lossless(hand));
+    return permutations == suit_permutations.end() ? 0 : permutations->second;
+}
+
+const std::unordered_map< unsigned long long, int >& HandCalculator::get_suit_permutations() {
+    if (suit_permutations.empty())
+        load_suit_permutations();
+
+    return suit_permutations;
+}
 
-    std::unordered_map< unsigned long long, int > suit_permutations;
-    std::unordered_map< int, std::vector<int> > hand_frequencies;
+std::vector<int> HandCalculator::hand_frequency(unsigned long long player_mask) {
+    /*
+        Calculates the different hands that is possible from player cards + board.
+    */
+    unsigned long long player_mask_compressed = compress_hand_lossless(player_mask);
+
+    auto cached_frequencies = hand_frequencies.find(player_mask_compressed);
+    if (cached_frequencies != hand_frequencies.end())
+        return cached_frequencies->second;
+
+    std::vector<int> frequencies(10,0);
+    calculations::hand_frequency_(frequencies, player_mask_compressed, 52);
+
+    hand_frequencies[player_mask_compressed] = frequencies;
+    return frequencies;
+}
+
+namespace calculations {
 
-    void calculate_suit_permutations(unsigned long long current_hand, int upper_bound, int max_cards) {
+    void calculate_suit_permutations(std::unordered_map< unsigned long long, int >& suit_permutations, unsigned long long current_hand, int upper_bound, int max_cards) {
         if (max_cards == 0) {
-            unsigned long long compressed_hand = compress_hand_lossless(current_hand);
-            if (calculations::suit_permutations.find(compressed_hand) != calculations::suit_permutations.end())
-                calculations::suit_permutations[compressed_hand]++;
-            else
-                calculations::suit_permutations[compressed_hand] = 1;
+            suit_permutations[compress_hand_lossless(current_hand)]++;
         } else {
             for (int x = 0; x < upper_bound; x++) {
                 if (current_hand & 1ULL<<x)
                     continue;
-                calculations::calculate_suit_permutations(current_hand | 1ULL<<x, x, max_cards - 1);
+                calculations::calculate_suit_permutations(suit_permutations, current_hand | 1ULL<<x, x, max_cards - 1);
             }
         }
     }
 
-    void load_suit_permutations() {
-        std::string file_name = "../../files/suit_permutations.txt";
-
-        if (!calculations::suit_permutations.empty())
-            return;
-
-        if (std::filesystem::exists(file_name)) {
-            std::ifstream ifs(file_name);
-            boost::archive::text_iarchive ia(ifs);
-            ia >> calculations::suit_permutations;
-            ifs.close();
-        } else {
-            for (int max_cards = 1; max_cards <= 7; ++max_cards)
-                calculations::calculate_suit_permutations(0ULL, 52, max_cards);
-            std::ofstream ofs(file_name);
-            boost::archive::text_oarchive oa(ofs);
-            oa << calculations::suit_permutations;
-            ofs.close();
-        }
-    }
-
-    int num_suit_permutations(unsigned long long hand) {
-        if (calculations::suit_permutations.empty())
-            calculations::load_suit_permutations();
-
-        return calculations::suit_permutations[compress_hand_lossless(hand)];
-    }
-
     void hand_frequency_(std::vector<int> &frequencies, unsigned long long current_hand, int upper_bound) {
         if (__builtin_popcountll(current_hand) == 7) {
             frequencies[Holdem::CalculateHandStrength(current_hand)>>26]++;
@@ -99,22 +117,6 @@ namespace calculations {
         }
     }
 
-    std::vector<int> hand_frequency(unsigned long long player_mask) {
-        /*
-            Calculates the different hands that is possible from player cards + board.
-        */
-        unsigned long long player_mask_compressed = compress_hand_lossless(player_mask);
-
-        if (calculations::hand_frequencies.find(player_mask_compressed) != calculations::hand_frequencies.end())
-            return calculations::hand_frequencies[player_mask_compressed];
-
-        std::vector<int> frequencies(10,0);
-        calculations::hand_frequency_(frequencies, player_mask_compressed, 52);
-
-        calculations::hand_frequencies[player_mask_compressed] = frequencies;
-        return frequencies;
-    }
-
     void headsup_tabled_outcomes(unsigned long long player_cards, unsigned long long opponent_cards, unsigned long long board_cards, int upper_bound, std::vector<unsigned long> &outcomes) {
         if (__builtin_popcountll(board_cards) == 5) {
             unsigned long our_strength = Holdem::CalculateHandStrength(player_cards | board_cards);
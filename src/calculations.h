@@ -14,14 +14,27 @@
 
 unsigned long long compress_hand_lossless(unsigned long long);
 
+class HandCalculator {
+    /*
+        Owns the tables behind the hand calculations, so that every solver can keep its own. The
+        suit permutations are read from a file, or calculated and written to it, the first time
+        they are needed. A calculator is used by one thread at a time.
+    */
+    public:
+        void load_suit_permutations();
+        int num_suit_permutations(unsigned long long);
+        const std::unordered_map< unsigned long long, int >& get_suit_permutations();
+        std::vector<int> hand_frequency(unsigned long long);
+
+    private:
+        std::unordered_map< unsigned long long, int > suit_permutations;
+        std::unordered_map< unsigned long long, std::vector<int> > hand_frequencies;
+};
+
 namespace calculations {
 
-    extern std::unordered_map< unsigned long long, int > suit_permutations;
-    extern std::unordered_map< int, std::vector<int> > hand_frequencies;
-    void load_suit_permutations();
-    int num_suit_permutations(unsigned long long);
+    void calculate_suit_permutations(std::unordered_map< unsigned long long, int >&, unsigned long long, int, int);
     void hand_frequency_(std::vector<int>&, unsigned long long, int);
-    std::vector<int> hand_frequency(unsigned long long);
     void headsup_tabled_outcomes(unsigned long long, unsigned long long, unsigned long long, int, std::vector<unsigned long long>&);
     std::vector<unsigned long> headsup_outcomes(unsigned long long, unsigned long long);
 
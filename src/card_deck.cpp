@@ -29,3 +29,18 @@ void CardDeck::Shuffle() {
     std::random_shuffle( card_deck.begin() + top, card_deck.end() );
 }
 
+
+void CardDeck::ShuffleTop(int num_cards, Rng& rng, unsigned long long excluded) {
+    // Only the next num_cards cards are drawn uniformly from the remaining deck, which is all a hand needs.
+    // Excluded cards are drawn again, so they never end up among the next cards.
+    for (int x = top; x < top + num_cards; x++)
+        do
+            std::swap( card_deck[x], card_deck[x + rng() % (card_deck.size() - x)] );
+        while (card_deck[x] & excluded);
+}
+
+void CardDeck::PutOnTop(const std::vector<unsigned long long>& cards) {
+    // Move the given cards, in order, to the top of the remaining deck.
+    for (unsigned int x = 0; x < cards.size(); x++)
+        std::swap( card_deck[top + x], *std::find( card_deck.begin() + top + x, card_deck.end(), cards[x] ) );
+}
@@ -6,6 +6,7 @@
 #include <algorithm>
 #include <utility>
 #include <iostream>
+#include "rng.h"
 
 enum class Card {
     c, d, h, s,
@@ -20,6 +21,8 @@ class CardDeck {
         void PutBack();
         void PutBackAll();
         void Shuffle();
+        void ShuffleTop(int, Rng&, unsigned long long = 0ULL);
+        void PutOnTop(const std::vector<unsigned long long>&);
     private:
         std::vector< unsigned long long > card_deck;
         int top;
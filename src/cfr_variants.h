@@ -0,0 +1,75 @@
+#ifndef CFR_VARIANTS_H
+#define CFR_VARIANTS_H
+
+#include <cmath>
+#include <limits>
+
+// The factors that the regrets and the cumulative strategy are multiplied with after an iteration.
+struct Discount {
+    float positive_regret;
+    float negative_regret;
+    float strategy;
+
+    // The regret after the instant regret of an iteration is added, discounted by its sign.
+    inline float update_regret(float regret, float instant_regret) const {
+        regret += instant_regret;
+        return regret * (regret > 0.0f ? positive_regret : negative_regret);
+    }
+
+    inline float update_strategy(float cumulative_strategy, float weight) const {
+        return (cumulative_strategy + weight) * strategy;
+    }
+};
+
+struct CFRVariant {
+    /*
+        The variants are all special cases of discounted CFR (https://arxiv.org/abs/1809.04040).
+        After iteration t, positive regrets are multiplied by t^alpha/(t^alpha + 1), negative
+        regrets by t^beta/(t^beta + 1) and the cumulative strategy by (t/(t + 1))^gamma. An
+        infinite exponent keeps (+inf) or resets (-inf) the regrets.
+    */
+    double alpha;
+    double beta;
+    double gamma;
+
+    static inline double regret_discount(double t, double exponent) {
+        if (std::isinf(exponent))
+            return exponent > 0.0 ? 1.0 : 0.0;
+        double weight = std::pow(t, exponent);
+        return weight / (weight + 1.0);
+    }
+
+    inline Discount get_discount(int timestep) const {
+        double t = static_cast<double>(timestep + 1);
+        return Discount{
+            static_cast<float>(regret_discount(t, alpha)),
+            static_cast<float>(regret_discount(t, beta)),
+            static_cast<float>(std::pow(t / (t + 1.0), gamma))
+        };
+    }
+};
+
+namespace cfr_variants {
+
+    constexpr double INF = std::numeric_limits<double>::infinity();
+
+    inline CFRVariant vanilla() {
+        return CFRVariant{INF, INF, 0.0};
+    }
+
+    inline CFRVariant cfr_plus() {
+        // Negative regrets are floored at zero and the average strategy is weighted linearly.
+        return CFRVariant{INF, -INF, 1.0};
+    }
+
+    inline CFRVariant linear() {
+        return CFRVariant{1.0, 1.0, 1.0};
+    }
+
+    inline CFRVariant discounted(double alpha, double beta, double gamma) {
+        return CFRVariant{alpha, beta, gamma};
+    }
+
+}
+
+#endif
@@ -0,0 +1,215 @@
+#include "checkpoint.h"
+#include <cstdio>
+#include <fstream>
+#include <sys/wait.h>
+#include <unistd.h>
+
+
+Checkpointer::Checkpointer(std::string file_name) : file_name{file_name}, writing{false}, failed{false} {}
+
+Checkpointer::~Checkpointer() {
+    // A destructor can not throw, so a failure that was not reported yet is dropped.
+    join();
+}
+
+void Checkpointer::write(std::function<void(std::vector<char>&)> serialize) {
+    // The previous write has to be finished first, so that the checkpoints are written in order.
+    wait();
+    writing = true;
+    pid_t child = fork();
+    if (child == 0) {
+        // The child only has the forking thread, and leaves without running the exit handlers of the parent.
+        std::vector<char> snapshot;
+        serialize(snapshot);
+        _exit(write_file(snapshot) ? 0 : 1);
+    } else if (child < 0) {
+        buffer.clear();
+        serialize(buffer);
+        writer = std::thread([this]() {
+            failed = !write_file(buffer);
+            writing = false;
+        });
+        return;
+    }
+    writer = std::thread([this, child]() {
+        int status;
+        failed = waitpid(child, &status, 0) != child || !WIFEXITED(status) || WEXITSTATUS(status) != 0;
+        writing = false;
+    });
+}
+
+bool Checkpointer::is_writing() {
+    return writing;
+}
+
+void Checkpointer::join() {
+    if (writer.joinable())
+        writer.join();
+}
+
+void Checkpointer::wait() {
+    join();
+    if (failed) {
+        failed = false;
+        throw std::runtime_error("Could not write the checkpoint.");
+    }
+}
+
+bool Checkpointer::exists() {
+    return std::ifstream(file_name).good();
+}
+
+std::vector<char> Checkpointer::read() {
+    std::ifstream ifs(file_name, std::ios::binary);
+    return std::vector<char>(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+}
+
+bool Checkpointer::write_file(const std::vector<char>& data) {
+    std::string tmp_file_name = file_name + ".tmp";
+    std::ofstream ofs(tmp_file_name, std::ios::binary | std::ios::trunc);
+    ofs.write(data.data(), data.size());
+    ofs.close();
+    // The previous checkpoint is kept when the new one can not be written.
+    return ofs && std::rename(tmp_file_name.c_str(), file_name.c_str()) == 0;
+}
+
+namespace checkpoint {
+
+    constexpr uint64_t MAGIC = 0x54504b4355425050ULL;
+    constexpr uint32_t VERSION = 2;
+
+    void write_header(std::vector<char>& buffer, Solver solver, int timestep) {
+        write<uint64_t>(buffer, MAGIC);
+        write<uint32_t>(buffer, VERSION);
+        // The nodes and records are copied byte by byte, so their sizes have to match when reading.
+        write<uint32_t>(buffer, MAX_MOVES);
+        write<uint32_t>(buffer, MAX_CARDS);
+        write<Solver>(buffer, solver);
+        write<int32_t>(buffer, timestep);
+    }
+
+    int read_header(Reader& reader, Solver solver) {
+        if (read<uint64_t>(reader) != MAGIC || read<uint32_t>(reader) != VERSION)
+            throw std::runtime_error("The file is not a checkpoint of this version.");
+        if (read<uint32_t>(reader) != MAX_MOVES || read<uint32_t>(reader) != MAX_CARDS)
+            throw std::runtime_error("The checkpoint was written by a build with other storage sizes.");
+        if (read<Solver>(reader) != solver)
+            throw std::runtime_error("The checkpoint was written by another solver.");
+        return read<int32_t>(reader);
+    }
+
+    RegretStorage read_storage(Reader& reader) {
+        // The value is checked before it is cast, so an unknown storage is never used.
+        std::underlying_type<RegretStorage>::type storage = read<std::underlying_type<RegretStorage>::type>(reader);
+        if (storage < static_cast<int>(RegretStorage::HASH_MAP) || storage > static_cast<int>(RegretStorage::BLOCK))
+            throw std::runtime_error("The checkpoint has an invalid regret storage.");
+        return static_cast<RegretStorage>(storage);
+    }
+
+    void write_random_engine(std::vector<char>& buffer, Rng& random_engine) {
+        write(buffer, random_engine.state);
+        write<int32_t>(buffer, random_engine.front);
+        write<int32_t>(buffer, random_engine.rear);
+    }
+
+    void read_random_engine(Reader& reader, Rng& random_engine) {
+        random_engine.state = read<std::array<int32_t, Rng::DEGREE>>(reader);
+        random_engine.front = read<int32_t>(reader);
+        random_engine.rear = read<int32_t>(reader);
+        if (random_engine.front < 0 || random_engine.front >= Rng::DEGREE || random_engine.rear < 0 || random_engine.rear >= Rng::DEGREE)
+            throw std::runtime_error("The checkpoint has an invalid random engine.");
+    }
+
+    void write_table(std::vector<char>& buffer, robin_hood::unordered_map<uint64_t, robin_hood::unordered_map<Move, float>>& table) {
+        buffer.reserve(buffer.size() + table.size() * (sizeof(uint64_t) + sizeof(uint32_t) + MAX_MOVES * (sizeof(Move) + sizeof(float))));
+        write<uint64_t>(buffer, table.size());
+        for (auto const& [infoset, infoset_values]:table) {
+            write<uint64_t>(buffer, infoset);
+            write<uint32_t>(buffer, infoset_values.size());
+            for (auto const& [action, value]:infoset_values) {
+                write<Move>(buffer, action);
+                write<float>(buffer, value);
+            }
+        }
+    }
+
+    void read_table(Reader& reader, robin_hood::unordered_map<uint64_t, robin_hood::unordered_map<Move, float>>& table) {
+        table.clear();
+        uint64_t num_infosets = read<uint64_t>(reader);
+        reader.check_count(num_infosets, sizeof(uint64_t) + sizeof(uint32_t));
+        table.reserve(num_infosets);
+        for (uint64_t x=0; x<num_infosets; ++x) {
+            robin_hood::unordered_map<Move, float>& infoset_values = table[read<uint64_t>(reader)];
+            uint32_t num_actions = read<uint32_t>(reader);
+            reader.check_count(num_actions, sizeof(Move) + sizeof(float));
+            for (uint32_t y=0; y<num_actions; ++y) {
+                Move action = read<Move>(reader);
+                infoset_values[action] = read<float>(reader);
+            }
+        }
+    }
+
+    void write_tree(std::vector<char>& buffer, Tree& tree) {
+        // The nodes are written in index order, so the children indices stay valid when read back.
+        size_t size_position = buffer.size();
+        uint32_t num_nodes = 0;
+        write<uint32_t>(buffer, num_nodes);
+        tree.for_each_node([&buffer, &num_nodes](Node& node) {
+            for (std::atomic<uint32_t>& child:node.children)
+                write<uint32_t>(buffer, child.load(std::memory_order_relaxed));
+            write(buffer, node.infoset_regret);
+            write(buffer, node.infoset_strategy);
+            ++num_nodes;
+        });
+        std::memcpy(buffer.data() + size_position, &num_nodes, sizeof(num_nodes));
+    }
+
+    void read_tree(Reader& reader, Tree& tree) {
+        uint32_t num_nodes = read<uint32_t>(reader);
+        reader.check_count(num_nodes, MAX_MOVES * sizeof(uint32_t) + sizeof(Node::infoset_regret) + sizeof(Node::infoset_strategy));
+        if (num_nodes == 0 || num_nodes > Tree::MAX_CHUNKS * Tree::CHUNK_SIZE)
+            throw std::runtime_error("The checkpoint has an invalid tree.");
+        tree.resize(num_nodes);
+        for (uint32_t index=0; index<num_nodes; ++index) {
+            Node* node = tree.get_node(index);
+            for (std::atomic<uint32_t>& child:node->children) {
+                uint32_t child_index = read<uint32_t>(reader);
+                if (child_index >= num_nodes)
+                    throw std::runtime_error("The checkpoint has an invalid tree.");
+                child.store(child_index, std::memory_order_relaxed);
+            }
+            reader.read_bytes(node->infoset_regret, sizeof(node->infoset_regret));
+            reader.read_bytes(node->infoset_strategy, sizeof(node->infoset_strategy));
+        }
+    }
+
+    void write_blocks(std::vector<char>& buffer, BlockTable& blocks) {
+        write<uint64_t>(buffer, blocks.size());
+        for (auto& [public_state, block] : blocks) {
+            write<uint64_t>(buffer, public_state);
+            write<uint32_t>(buffer, block.num_actions);
+            write<uint32_t>(buffer, block.get_num_private_states());
+            const char* regret = reinterpret_cast<const char*>(block.regret.data());
+            buffer.insert(buffer.end(), regret, regret + block.regret.size() * sizeof(float));
+            const char* strategy = reinterpret_cast<const char*>(block.strategy.data());
+            buffer.insert(buffer.end(), strategy, strategy + block.strategy.size() * sizeof(float));
+        }
+    }
+
+    void read_blocks(Reader& reader, BlockTable& blocks) {
+        blocks.clear();
+        uint64_t num_blocks = read<uint64_t>(reader);
+        reader.check_count(num_blocks, sizeof(uint64_t) + 2 * sizeof(uint32_t));
+        for (uint64_t x=0; x<num_blocks; ++x) {
+            Block& block = blocks[read<uint64_t>(reader)];
+            uint32_t num_actions = read<uint32_t>(reader);
+            uint32_t num_private_states = read<uint32_t>(reader);
+            if (num_actions == 0 || num_private_states == 0)
+                throw std::runtime_error("The checkpoint has an invalid block.");
+            reader.check_count(static_cast<uint64_t>(num_actions) * num_private_states, 2 * sizeof(float));
+            block.resize(num_private_states, num_actions);
+            reader.read_bytes(block.regret.data(), block.regret.size() * sizeof(float));
+            reader.read_bytes(block.strategy.data(), block.strategy.size() * sizeof(float));
+        }
+    }
+}
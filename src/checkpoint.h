@@ -0,0 +1,132 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <atomic>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "game.h"
+#include "rng.h"
+#include "sharded_table.h"
+#include "tree.h"
+#include "../lib/robin_hood.h"
+
+class Checkpointer {
+    /*
+        Writes checkpoints to a file without holding up the solver. write() forks the process, and
+        the child serializes the state of the solver from its copy-on-write snapshot and writes
+        the file, so the solver only waits for the fork and not for the size of its tables. When
+        the process can not be forked, the state is serialized by the caller and only the file is
+        written on a background thread. The file is replaced atomically once it is complete. A
+        write that fails is reported by the next call to write() or wait().
+    */
+    public:
+        Checkpointer(std::string);
+        ~Checkpointer();
+        // The function serializes the state into the empty buffer it is given.
+        void write(std::function<void(std::vector<char>&)>);
+        bool is_writing();
+        void wait();
+        bool exists();
+        std::vector<char> read();
+
+    private:
+        std::string file_name;
+        // Only used when the process can not be forked.
+        std::vector<char> buffer;
+        std::thread writer;
+        std::atomic<bool> writing;
+        // Set by the writer thread, and read after it is joined.
+        bool failed;
+
+        void join();
+        bool write_file(const std::vector<char>&);
+};
+
+namespace checkpoint {
+
+    enum class Solver : uint32_t {
+        MCCFR, LCFR
+    };
+
+    template <typename T>
+    inline void write(std::vector<char>& buffer, const T& value) {
+        const char* bytes = reinterpret_cast<const char*>(&value);
+        buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+    }
+
+    class Reader {
+        // Reads a checkpoint front to back, and throws instead of reading past its end.
+        public:
+            Reader(const std::vector<char>& buffer) : position{buffer.data()}, end{buffer.data() + buffer.size()} {}
+
+            inline size_t remaining() const {
+                return end - position;
+            }
+
+            inline void read_bytes(void* destination, size_t size) {
+                if (size > remaining())
+                    throw std::runtime_error("The checkpoint is truncated.");
+                std::memcpy(destination, position, size);
+                position += size;
+            }
+
+            // Checks a count that was read against the bytes that are left, before anything is allocated for it.
+            inline void check_count(uint64_t count, size_t item_size) {
+                if (count > remaining() / item_size)
+                    throw std::runtime_error("The checkpoint is truncated.");
+            }
+
+        private:
+            const char* position;
+            const char* end;
+    };
+
+    template <typename T>
+    inline T read(Reader& reader) {
+        T value;
+        reader.read_bytes(&value, sizeof(T));
+        return value;
+    }
+
+    // For tables whose values are plain records that can be copied byte by byte.
+    template <typename T>
+    void write_records(std::vector<char>& buffer, ShardedTable<T>& table) {
+        buffer.reserve(buffer.size() + sizeof(uint64_t) + table.size() * (sizeof(uint64_t) + sizeof(T)));
+        write<uint64_t>(buffer, table.size());
+        table.for_each([&buffer](uint64_t key, T& record) {
+            write<uint64_t>(buffer, key);
+            write<T>(buffer, record);
+        });
+    }
+
+    template <typename T>
+    void read_records(Reader& reader, ShardedTable<T>& table) {
+        table.clear();
+        uint64_t num_records = read<uint64_t>(reader);
+        reader.check_count(num_records, sizeof(uint64_t) + sizeof(T));
+        table.reserve(num_records);
+        for (uint64_t x=0; x<num_records; ++x) {
+            uint64_t key = read<uint64_t>(reader);
+            table[key] = read<T>(reader);
+        }
+    }
+
+    void write_header(std::vector<char>&, Solver, int);
+    int read_header(Reader&, Solver);
+    RegretStorage read_storage(Reader&);
+    void write_random_engine(std::vector<char>&, Rng&);
+    void read_random_engine(Reader&, Rng&);
+    void write_table(std::vector<char>&, robin_hood::unordered_map<uint64_t, robin_hood::unordered_map<Move, float>>&);
+    void read_table(Reader&, robin_hood::unordered_map<uint64_t, robin_hood::unordered_map<Move, float>>&);
+    void write_tree(std::vector<char>&, Tree&);
+    void read_tree(Reader&, Tree&);
+    void write_blocks(std::vector<char>&, BlockTable&);
+    void read_blocks(Reader&, BlockTable&);
+
+}
+
+#endif
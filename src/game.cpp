@@ -19,6 +19,8 @@ std::unordered_map<Cards, char> cards_to_char = {
     {Cards::J, 'J'}
 };
 
+thread_local Rng random_engine;
+
 std::string infoset_to_string(uint64_t infoset) {
     int pos = 0;
     std::string readable_infoset;
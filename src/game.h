@@ -3,6 +3,7 @@
 
 #include <chrono>
 #include <vector>
+#include <memory>
 #include <string>
 #include <set>
 #include <iostream>
@@ -10,12 +11,19 @@
 #include <unordered_map>
 #include <bits/stdc++.h>
 #include <cassert>
+#include "rng.h"
 
 #define assertm(exp, msg) assert(((void)msg, exp))
 
 constexpr int MAX_MOVE_SIZE = 2;
 constexpr int MAX_CARD_SIZE = 3;
-constexpr int MAX_MOVES = 2;
+// The most actions at a node that the fixed-size solver storage (trees and quantized records) has
+// room for. Kuhn poker needs two and hold'em with the default pot-sized raise three; builds for
+// hold'em with larger bet-size menus raise it. The solvers check it against Game::get_max_actions.
+#ifndef MAX_ACTIONS
+#define MAX_ACTIONS 3
+#endif
+constexpr int MAX_MOVES = MAX_ACTIONS;
 constexpr int MAX_CARDS = 4;
 constexpr uint32_t MOVE_MASK = 3;
 constexpr uint32_t CARDS_MASK = 7;
@@ -28,11 +36,28 @@ enum class Move : uint32_t {
     NONE=0, F, C, R
 };
 
+// Games with several raise sizes use the moves after R, so the n-th raise size is R + n.
+inline Move raise_move(int size) {
+    return static_cast<Move>(static_cast<uint32_t>(Move::R) + size);
+}
+
+inline bool is_raise(Move move) {
+    return static_cast<uint32_t>(move) >= static_cast<uint32_t>(Move::R);
+}
+
+inline int get_raise_size(Move move) {
+    return static_cast<int>(static_cast<uint32_t>(move) - static_cast<uint32_t>(Move::R));
+}
+
 extern std::unordered_map<char, Move> char_to_move;
 extern std::unordered_map<Move, char> move_to_char;
 extern std::unordered_map<Cards, char> cards_to_char;
 
 extern std::string infoset_to_string(uint64_t infoset);
+
+// The games sample from the engine of their thread unless they are given one. The solvers give
+// them their own engine, so that solvers on one thread do not share any state.
+extern thread_local Rng random_engine;
 /*
 std::string infoset_to_string(uint64_t infoset) {
     int pos = 0;
@@ -120,12 +145,27 @@ inline uint64_t to_infoset(std::string history, Cards player_card) {
     return (((uint64_t)History(history).history) << MAX_CARD_SIZE) | (uint64_t)player_card;
 };
 
+class InfosetObserver {
+    // Is told about every decision node where a game lists the legal actions, if it is set on the game.
+    public:
+        virtual void observe(int, uint64_t, const std::vector<Move>&) = 0;
+};
+
 class Game {
     public:
         virtual void reset_game() {};
+        // Deals a new hand with the given random engine instead of the one of the thread.
+        virtual void reset_game(Rng&) {};
         virtual inline int get_num_players() {};
         virtual inline int get_player_to_move() {};
         virtual inline uint64_t get_infoset(int) {};
+        // The infoset split into the part that every player sees and the part that only the player sees.
+        virtual inline uint64_t get_public_state() {};
+        virtual inline int get_private_state(int) {};
+        virtual inline int get_num_private_states() {};
+        virtual void set_private_state(int, int) {};
+        // Whether the private states that are set can be dealt together, with each other and with the public cards.
+        virtual inline bool is_valid_deal() { return true; };
         virtual inline uint64_t get_current_infoset() {};
         virtual inline bool is_player_to_move(int) {};
         virtual inline bool is_player_in_hand(int) {};
@@ -136,10 +176,21 @@ class Game {
         virtual inline bool is_finished() {};
         virtual float get_outcome_for_player(int) {};
         virtual std::vector<Move>& get_actions(std::vector<Move>&) {};
+        // The most actions at any node of the game.
+        virtual inline int get_max_actions() {};
         virtual Move get_random_action() {};
         virtual inline Move sample_action() {};
-        virtual std::set<uint64_t> get_encountered_infosets(int) {};
-        virtual std::vector<Move> get_actions_from_infoset(uint64_t) {};
+        // Draws the outcomes of the chance nodes that are still to come again, keeping the ones already dealt.
+        virtual void resample_chance(Rng&) {};
+        // A copy of the game in its current state, for traversing it from another thread. The copy has no infoset observer.
+        virtual std::unique_ptr<Game> clone() {};
+
+        void set_infoset_observer(InfosetObserver* observer) {
+            infoset_observer = observer;
+        }
+
+    protected:
+        InfosetObserver* infoset_observer = nullptr;
 };
 
 #endif
@@ -0,0 +1,14 @@
+#ifndef HASH_H
+#define HASH_H
+
+#include <cstdint>
+
+inline uint64_t hash_combine(uint64_t hash, uint64_t value) {
+    // The splitmix64 finalizer over the combined values.
+    uint64_t x = hash ^ (value + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2));
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+#endif
@@ -1,25 +1,403 @@
 #include "holdem.h"
 #include "card_deck.h"
+#include "hash.h"
+#include "trace.h"
 
 
-Holdem::Holdem(int num_players) {
+namespace {
 
+    std::vector<unsigned long long> create_hole_card_combinations() {
+        std::vector<unsigned long long> combinations;
+        for (int first = 0; first < 52; first++)
+            for (int second = first + 1; second < 52; second++)
+                combinations.push_back((1ULL<<first) | (1ULL<<second));
+        return combinations;
+    }
+
+    const std::vector<unsigned long long> hole_card_combinations = create_hole_card_combinations();
+
+}
+
+Holdem::Holdem(int num_players) : Holdem(std::vector<int>(num_players, 10000), 50, 100) {}
+
+Holdem::Holdem(std::vector<int> stacks, int small_blind, int big_blind) : Holdem(stacks, small_blind, big_blind, ActionAbstraction()) {}
+
+Holdem::Holdem(std::vector<int> stacks, int small_blind, int big_blind, ActionAbstraction abstraction) : players{static_cast<int>(stacks.size())}, small_blind{small_blind}, big_blind{big_blind}, stacks{stacks}, abstraction{abstraction} {
+    assertm(players >= 2 && players <= 6, "There are two to six players.");
+    for (int stack:stacks)
+        assertm(stack > big_blind, "The players can afford the blinds.");
+    hole_cards.resize(players);
+    contributions.resize(players);
+    folded.resize(players);
+    all_in.resize(players);
+    acted_at_opening.resize(players);
+    reset_game();
+}
+
+void Holdem::reset_game() {
+    reset_game(random_engine);
+}
+
+void Holdem::reset_game(Rng& rng) {
+    deck.PutBackAll();
+    deck.ShuffleTop(2 * players + 5, rng);
+    initialize_hand();
+}
+
+void Holdem::reset_game(const std::vector<unsigned long long>& cards) {
+    // Deals the given cards first: the hole cards in seat order, then the board.
+    deck.PutBackAll();
+    deck.PutOnTop(cards);
+    for (unsigned int x = 0; x < cards.size(); x++)
+        deck.PickTop();
+    deck.ShuffleTop(std::max(2 * players + 5 - static_cast<int>(cards.size()), 0), random_engine);
+    deck.PutBackAll();
+    initialize_hand();
+}
+
+void Holdem::initialize_hand() {
+    for (int player = 0; player < players; player++)
+        hole_cards[player] = deck.PickTop() | deck.PickTop();
+    board = 0;
+    std::fill(contributions.begin(), contributions.end(), 0);
+    std::fill(folded.begin(), folded.end(), false);
+    std::fill(all_in.begin(), all_in.end(), false);
+    // Posting a blind is not acting, so the big blind can still raise when the others call.
+    std::fill(acted_at_opening.begin(), acted_at_opening.end(), -1);
+    opening = 0;
+    contributions[0] = small_blind;
+    contributions[1] = big_blind;
+    pot = small_blind + big_blind;
+    current_bet = big_blind;
+    min_raise = big_blind;
+    num_raises = 0;
+    round = 0;
+    num_in_hand = players;
+    num_all_in = 0;
+    num_to_act = players;
+    // Heads-up, the small blind has the button and acts first before the flop.
+    player_to_move = 2 % players;
+    public_hash = hash_combine(0, players);
+    undo_log.clear();
+}
+
+void Holdem::start_round() {
+    min_raise = big_blind;
+    num_raises = 0;
+    opening++;
+    int can_act = num_in_hand - num_all_in;
+    num_to_act = can_act > 1 ? can_act : 0;
+    // After the flop the first player after the button acts first, which is the big blind heads-up.
+    player_to_move = next_player_to_act(players == 2 ? 0 : players - 1);
+}
+
+int Holdem::next_player_to_act(int player) {
+    for (int x = 1; x <= players; x++) {
+        int next_player = (player + x) % players;
+        if (!folded[next_player] && !all_in[next_player])
+            return next_player;
+    }
+    return player;
+}
+
+int Holdem::get_num_players() {
+    return players;
+}
+
+int Holdem::get_player_to_move() {
+    return player_to_move;
 }
 
-// GetMoves
-// ExecuteMove
-// GetState
-// CalculateWinningProbForEachWinCategory
-// IsFinished
-bool Holdem::IsFinished() {
+uint64_t Holdem::get_infoset(int player) {
+    return hash_combine(hash_combine(public_hash, player), hole_cards[player]);
+}
+
+int Holdem::get_num_private_states() {
+    return NUM_HOLE_CARD_COMBINATIONS;
+}
+
+uint64_t Holdem::get_public_state() {
+    return public_hash;
+}
+
+int Holdem::get_private_state(int player) {
+    // The inverse of set_private_state: the combinations are ordered by their lowest card, then their highest card.
+    int first = __builtin_ctzll(hole_cards[player]);
+    int second = 63 - __builtin_clzll(hole_cards[player]);
+    return first*51 - first*(first - 1)/2 + second - first - 1;
+}
+
+void Holdem::set_private_state(int player, int private_state) {
+    // The private state is the index of the hole cards among all combinations. The deck is not
+    // changed, so the caller keeps the cards of the players and the board apart.
+    hole_cards[player] = hole_card_combinations[private_state];
+}
+
+bool Holdem::is_valid_deal() {
+    // The private states are set without the deck, so the hole cards can overlap each other or the board.
+    unsigned long long dealt = board;
+    for (int player = 0; player < players; player++) {
+        if (hole_cards[player] & dealt)
+            return false;
+        dealt |= hole_cards[player];
+    }
     return true;
 }
-// GetOutCome
 
+uint64_t Holdem::get_current_infoset() {
+    return get_infoset(player_to_move);
+}
+
+bool Holdem::is_player_to_move(int player) {
+    return player == player_to_move;
+}
+
+bool Holdem::is_player_in_hand(int player) {
+    return !folded[player];
+}
+
+bool Holdem::is_chance_node() {
+    return num_to_act == 0 && num_in_hand > 1 && round < NUM_ROUNDS - 1;
+}
+
+int Holdem::betting_round() {
+    return round;
+}
+
+int Holdem::get_raise_to(int size) {
+    // Call, then raise by the fraction of the pot after the call.
+    float pot_fraction = abstraction.get_raise_sizes(round, num_raises)[size];
+    if (pot_fraction == ActionAbstraction::ALL_IN)
+        return stacks[player_to_move];
+    int to_call = current_bet - contributions[player_to_move];
+    int raise_to = current_bet + std::max(min_raise, static_cast<int>(std::lround(pot_fraction * (pot + to_call))));
+    return std::min(raise_to, stacks[player_to_move]);
+}
+
+Move Holdem::translate_raise(int raise_to) {
+    return translate_raise(raise_to, random_engine);
+}
 
-/*
-    Variables: bigblindsize, smallblindsize, dealer (bigblind and small blind), playerinfor, revealedcards, players.
-*/
+Move Holdem::translate_raise(int raise_to, Rng& rng) {
+    // Maps a raise to an amount that may not be in the abstraction onto one of the raises that are.
+    std::vector<Move> actions;
+    get_actions(actions);
+    std::vector<Move> raises;
+    std::vector<int> raise_tos;
+    for (Move action:actions) {
+        if (is_raise(action)) {
+            raises.push_back(action);
+            raise_tos.push_back(get_raise_to(get_raise_size(action)));
+        }
+    }
+    assertm(!raises.empty(), "The player can raise.");
+    int upper = std::lower_bound(raise_tos.begin(), raise_tos.end(), raise_to) - raise_tos.begin();
+    if (upper == raises.size())
+        return raises.back();
+    if (upper == 0 || raise_tos[upper] == raise_to)
+        return raises[upper];
+    float pot_after_call = static_cast<float>(pot + current_bet - contributions[player_to_move]);
+    float probability = ActionAbstraction::get_lower_probability((raise_tos[upper - 1] - current_bet) / pot_after_call, (raise_tos[upper] - current_bet) / pot_after_call, (raise_to - current_bet) / pot_after_call);
+    float r = static_cast<float>(rng()) / static_cast<float>(Rng::MAX);
+    return r < probability ? raises[upper - 1] : raises[upper];
+}
+
+void Holdem::execute(Move& action) {
+    TRACE_SCOPE("execute");
+    int player = player_to_move;
+    undo_log.push(UndoEntry{player, contributions[player], static_cast<bool>(folded[player]), static_cast<bool>(all_in[player]), round, player_to_move, num_to_act, num_in_hand, num_all_in, current_bet, min_raise, num_raises, pot, opening, acted_at_opening[player], board, public_hash});
+
+    if (action == Move::NONE) {
+        assertm(is_chance_node(), "Cards are dealt between the betting rounds.");
+        int num_cards = round == 0 ? 3 : 1;
+        for (int x = 0; x < num_cards; x++) {
+            unsigned long long card = deck.PickTop();
+            board |= card;
+            public_hash = hash_combine(public_hash, card);
+        }
+        round++;
+        start_round();
+        return;
+    }
+
+    public_hash = hash_combine(public_hash, static_cast<uint64_t>(action));
+    if (action == Move::F) {
+        folded[player] = true;
+        num_in_hand--;
+        num_to_act--;
+    } else if (action == Move::C) {
+        int amount = std::min(current_bet, stacks[player]) - contributions[player];
+        contributions[player] += amount;
+        pot += amount;
+        if (contributions[player] == stacks[player]) {
+            all_in[player] = true;
+            num_all_in++;
+        }
+        num_to_act--;
+    } else {
+        int raise_to = get_raise_to(get_raise_size(action));
+        // Only a full raise reopens the betting. A smaller raise is always an all-in.
+        if (raise_to - current_bet >= min_raise) {
+            min_raise = raise_to - current_bet;
+            opening++;
+        }
+        num_raises++;
+        current_bet = raise_to;
+        pot += raise_to - contributions[player];
+        contributions[player] = raise_to;
+        if (raise_to == stacks[player]) {
+            all_in[player] = true;
+            num_all_in++;
+        }
+        // Everyone else that can still act has not matched the raise, so they have to respond to it.
+        num_to_act = num_in_hand - num_all_in - (all_in[player] ? 0 : 1);
+    }
+    // After a full raise, the raiser has acted at the opening it made.
+    acted_at_opening[player] = opening;
+    if (num_to_act > 0)
+        player_to_move = next_player_to_act(player);
+}
+
+void Holdem::undo() {
+    TRACE_SCOPE("undo");
+    UndoEntry entry = undo_log.pop();
+    if (entry.round != round) {
+        int num_cards = entry.round == 0 ? 3 : 1;
+        for (int x = 0; x < num_cards; x++)
+            deck.PutBack();
+    }
+    contributions[entry.player] = entry.contribution;
+    folded[entry.player] = entry.folded;
+    all_in[entry.player] = entry.all_in;
+    round = entry.round;
+    player_to_move = entry.player_to_move;
+    num_to_act = entry.num_to_act;
+    num_in_hand = entry.num_in_hand;
+    num_all_in = entry.num_all_in;
+    current_bet = entry.current_bet;
+    min_raise = entry.min_raise;
+    num_raises = entry.num_raises;
+    pot = entry.pot;
+    opening = entry.opening;
+    acted_at_opening[entry.player] = entry.acted_at_opening;
+    board = entry.board;
+    public_hash = entry.public_hash;
+}
+
+bool Holdem::is_finished() {
+    return num_in_hand == 1 || (num_to_act == 0 && round == NUM_ROUNDS - 1);
+}
+
+float Holdem::get_outcome_for_player(int player) {
+    assertm(is_finished(), "The game is finished.");
+    if (folded[player])
+        return -static_cast<float>(contributions[player]);
+    if (num_in_hand == 1)
+        return static_cast<float>(pot - contributions[player]);
+
+    // The pot is split into side pots at every distinct contribution, and each side pot goes to
+    // the best hands among the players that are still in and have paid into it.
+    unsigned long strengths[6];
+    for (int x = 0; x < players; x++)
+        strengths[x] = folded[x] ? 0 : Holdem::CalculateHandStrength(hole_cards[x] | board);
+    float winnings = 0.0f;
+    int previous_level = 0;
+    while (previous_level < contributions[player]) {
+        int level = contributions[player];
+        for (int x = 0; x < players; x++)
+            if (contributions[x] > previous_level && contributions[x] < level)
+                level = contributions[x];
+        int side_pot = 0;
+        unsigned long best_strength = 0;
+        for (int x = 0; x < players; x++) {
+            side_pot += std::min(contributions[x], level) - std::min(contributions[x], previous_level);
+            if (!folded[x] && contributions[x] >= level)
+                best_strength = std::max(best_strength, strengths[x]);
+        }
+        if (strengths[player] == best_strength) {
+            int num_winners = 0;
+            for (int x = 0; x < players; x++)
+                num_winners += !folded[x] && contributions[x] >= level && strengths[x] == best_strength;
+            winnings += static_cast<float>(side_pot) / static_cast<float>(num_winners);
+        }
+        previous_level = level;
+    }
+    return winnings - static_cast<float>(contributions[player]);
+}
+
+std::vector<Move>& Holdem::get_actions(std::vector<Move>& actions) {
+    if (is_chance_node()) {
+        actions.emplace_back(Move::NONE);
+        return actions;
+    }
+    if (is_finished())
+        return actions;
+    int to_call = current_bet - contributions[player_to_move];
+    if (to_call > 0)
+        actions.emplace_back(Move::F);
+    actions.emplace_back(Move::C);
+    if (stacks[player_to_move] - contributions[player_to_move] > to_call && acted_at_opening[player_to_move] != opening) {
+        int previous_raise_to = current_bet;
+        const std::vector<float>& raise_sizes = abstraction.get_raise_sizes(round, num_raises);
+        for (int size = 0; size < raise_sizes.size(); size++) {
+            int raise_to = get_raise_to(size);
+            if (raise_to > previous_raise_to)
+                actions.emplace_back(raise_move(size));
+            previous_raise_to = raise_to;
+        }
+    }
+    if (infoset_observer != nullptr)
+        infoset_observer->observe(player_to_move, get_current_infoset(), actions);
+    return actions;
+}
+
+int Holdem::get_max_actions() {
+    return abstraction.get_max_actions();
+}
+
+Move Holdem::get_random_action() {
+    std::vector<Move> actions;
+    actions.reserve(get_max_actions());
+    get_actions(actions);
+    return actions[random_engine() % actions.size()];
+}
+
+std::unique_ptr<Game> Holdem::clone() {
+    std::unique_ptr<Game> game(new Holdem(*this));
+    game->set_infoset_observer(nullptr);
+    return game;
+}
+
+Move Holdem::sample_action() {
+    // The cards are shuffled when the hand starts, so dealing only takes them from the deck.
+    if (!is_chance_node())
+        throw std::runtime_error("Cards are only dealt between the betting rounds.");
+    return Move::NONE;
+}
+
+void Holdem::resample_chance(Rng& rng) {
+    // Draws the board cards that are still to come again, from the cards that no player holds.
+    unsigned long long held = board;
+    for (int player = 0; player < players; player++)
+        held |= hole_cards[player];
+    deck.ShuffleTop(5 - __builtin_popcountll(board), rng, held);
+}
+
+unsigned long long Holdem::get_hole_cards(int player) {
+    return hole_cards[player];
+}
+
+unsigned long long Holdem::get_board() {
+    return board;
+}
+
+int Holdem::get_pot() {
+    return pot;
+}
+
+int Holdem::get_contribution(int player) {
+    return contributions[player];
+}
 
 unsigned long Holdem::CalculateHighestMask(unsigned long long cards, int n) {
     /*
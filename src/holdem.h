@@ -1,4 +1,3 @@
-
 #ifndef HOLDEM_H
 #define HOLDEM_H
 
@@ -6,23 +5,124 @@
 #include <algorithm>
 #include <utility>
 #include <iostream>
+#include "game.h"
+#include "card_deck.h"
+#include "action_abstraction.h"
+#include "undo_log.h"
 
-struct Player {
-    int chips;
-    std::vector< std::pair<int, int> > hand;
-    std::vector<int> mapping;
-    int colours = 0;
-};
+class Holdem: public Game {
+    /*
+        No-limit Texas hold'em for two to six players. Player 0 posts the small blind and player
+        1 the big blind; with more players the last player has the button. Cards are bit masks
+        from the CardDeck, and a hand uses the top 2*players + 5 cards of a deck that is shuffled
+        when the hand starts.
+
+        The actions are fold, check/call and the raise sizes of the action abstraction, which by
+        default is a pot-sized raise. Raises are at least a minimum raise and at most the stack,
+        and sizes that end up as the same amount are only offered once. An all-in that is less
+        than a minimum raise does not reopen the betting: the players that already acted since
+        the last full raise can only call or fold. Dealing the next street
+        is a chance node, whose only action is Move::NONE. Every executed action pushes the few
+        values it changes onto an undo log, so execute and undo are O(1).
 
-class Holdem {
+        Infosets are 64-bit hashes of the public actions and cards, the seat and the hole cards
+        of the player, updated incrementally as the hand goes on.
+    */
     public:
+        static constexpr int NUM_ROUNDS = 4;
+        static constexpr int NUM_HOLE_CARD_COMBINATIONS = 1326;
+
         Holdem(int);
-        bool IsFinished();
-        int big_blind = 10, small_blind = 5, dealer = 0;
-        std::vector<int>  hand_bet;
-        unsigned long long board_mask = 0;
+        Holdem(std::vector<int>, int, int);
+        Holdem(std::vector<int>, int, int, ActionAbstraction);
+        void reset_game();
+        void reset_game(Rng&);
+        void reset_game(const std::vector<unsigned long long>&);
+        int get_num_players();
+        int get_player_to_move();
+        uint64_t get_infoset(int);
+        uint64_t get_public_state();
+        int get_private_state(int);
+        int get_num_private_states();
+        void set_private_state(int, int);
+        bool is_valid_deal();
+        uint64_t get_current_infoset();
+        bool is_player_to_move(int);
+        bool is_player_in_hand(int);
+        bool is_chance_node();
+        int betting_round();
+        void execute(Move&);
+        void undo();
+        bool is_finished();
+        float get_outcome_for_player(int);
+        std::vector<Move>& get_actions(std::vector<Move>&);
+        int get_max_actions();
+        Move get_random_action();
+        Move sample_action();
+        void resample_chance(Rng&);
+        std::unique_ptr<Game> clone();
+
+        unsigned long long get_hole_cards(int);
+        unsigned long long get_board();
+        int get_pot();
+        int get_contribution(int);
+        int get_raise_to(int);
+        Move translate_raise(int);
+        Move translate_raise(int, Rng&);
+
         static unsigned long CalculateHighestMask(unsigned long long, int);
         static unsigned long CalculateHandStrength(unsigned long long);
+
+    private:
+        struct UndoEntry {
+            int player;
+            int contribution;
+            bool folded;
+            bool all_in;
+            int round;
+            int player_to_move;
+            int num_to_act;
+            int num_in_hand;
+            int num_all_in;
+            int current_bet;
+            int min_raise;
+            int num_raises;
+            int pot;
+            int opening;
+            int acted_at_opening;
+            unsigned long long board;
+            uint64_t public_hash;
+        };
+
+        int players;
+        int small_blind, big_blind;
+        std::vector<int> stacks;
+        CardDeck deck;
+        std::vector<unsigned long long> hole_cards;
+        unsigned long long board;
+        std::vector<int> contributions;
+        std::vector<char> folded;
+        std::vector<char> all_in;
+        int round;
+        int player_to_move;
+        int num_to_act;
+        int num_in_hand;
+        int num_all_in;
+        int current_bet;
+        int min_raise;
+        int num_raises;
+        int pot;
+        // Counts the times the betting was opened, by a new round or a full raise. A player can
+        // only raise if the betting was opened since the player last acted.
+        int opening;
+        std::vector<int> acted_at_opening;
+        uint64_t public_hash;
+        ActionAbstraction abstraction;
+        UndoLog<UndoEntry> undo_log;
+
+        void initialize_hand();
+        void start_round();
+        int next_player_to_act(int);
 };
 
 #endif
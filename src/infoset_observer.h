@@ -0,0 +1,37 @@
+#ifndef INFOSET_OBSERVER_H
+#define INFOSET_OBSERVER_H
+
+#include <vector>
+#include "game.h"
+#include "../lib/robin_hood.h"
+
+class InfosetRecorder: public InfosetObserver {
+    /*
+        Records the infosets where each player was to act and their legal actions. Recording is
+        only done when the recorder is set as the observer of a game, so traversals that do not
+        need it pay nothing for it. public_tree::enumerate_infosets finds all infosets of a game
+        in one pass instead.
+    */
+    public:
+        InfosetRecorder(int num_players) : infosets(num_players) {}
+
+        void observe(int player, uint64_t infoset, const std::vector<Move>& legal_actions) {
+            if (infosets[player].insert(infoset).second)
+                actions[infoset] = legal_actions;
+        }
+
+        const robin_hood::unordered_flat_set<uint64_t>& get_infosets(int player) {
+            return infosets[player];
+        }
+
+        const std::vector<Move>& get_actions(uint64_t infoset) {
+            assertm(actions.find(infoset) != actions.end(), "Infoset is encountered before.");
+            return actions[infoset];
+        }
+
+    private:
+        std::vector<robin_hood::unordered_flat_set<uint64_t>> infosets;
+        robin_hood::unordered_map<uint64_t, std::vector<Move>> actions;
+};
+
+#endif
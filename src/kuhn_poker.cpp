@@ -1,4 +1,5 @@
 #include "kuhn_poker.h"
+#include "trace.h"
 #include <string>
 #include <utility>
 #include <algorithm>
@@ -18,29 +19,33 @@ KuhnPoker::KuhnPoker() {
 KuhnPoker::KuhnPoker(int num_players) {
     assertm(num_players == 2 || num_players == 3, "There are two or three players.");
     players=num_players;
-    encountered_infosets.resize(num_players, std::set<uint64_t>());
-    card_for_player.reserve(num_players);
+    card_for_player.resize(num_players);
     cards = {Cards::A, Cards::K, Cards::Q};
     if (num_players==3)
         cards.emplace_back(Cards::J);
-    initialize_hand();
+    initialize_hand(random_engine);
 }
 
 void KuhnPoker::reset_game() {
-    initialize_hand();
+    initialize_hand(random_engine);
 }
 
-void KuhnPoker::initialize_hand() {
+void KuhnPoker::reset_game(Rng& rng) {
+    initialize_hand(rng);
+}
+
+void KuhnPoker::initialize_hand(Rng& rng) {
     money_in_hand.assign(players, 1.0f);
     has_folded.assign(players, false);
     history.clear();
+    undo_log.clear();
     player_to_move = 0;
-    draw_cards();
+    draw_cards(rng);
 }
 
-void KuhnPoker::draw_cards() {
+void KuhnPoker::draw_cards(Rng& rng) {
     std::vector<Cards> shuffled_cards = cards;
-    std::random_shuffle(shuffled_cards.begin(), shuffled_cards.end());
+    std::random_shuffle(shuffled_cards.begin(), shuffled_cards.end(), [&rng](int n) { return rng() % n; });
 
     for (int x=0; x<players; ++x)
         card_for_player[x] = shuffled_cards[x];
@@ -66,6 +71,23 @@ inline uint64_t KuhnPoker::get_infoset(int player) {
     return create_infoset(history, card_for_player[player]);
 }
 
+inline uint64_t KuhnPoker::get_public_state() {
+    return history.history;
+}
+
+inline int KuhnPoker::get_private_state(int player) {
+    return static_cast<int>(std::find(cards.begin(), cards.end(), card_for_player[player]) - cards.begin());
+}
+
+inline int KuhnPoker::get_num_private_states() {
+    return cards.size();
+}
+
+void KuhnPoker::set_private_state(int player, int private_state) {
+    // The private state of a player is the index of its card in the deck.
+    card_for_player[player] = cards[private_state];
+}
+
 inline bool KuhnPoker::is_player_in_hand(int player) {
     return !has_folded[player];
 }
@@ -79,7 +101,8 @@ inline int KuhnPoker::betting_round() {
 }
 
 void KuhnPoker::execute(Move& action) {
-    encountered_infosets[player_to_move].insert(get_infoset(player_to_move));
+    TRACE_SCOPE("execute");
+    undo_log.push(UndoEntry{money_in_hand[player_to_move], has_folded[player_to_move]});
     history+=action;
     if (action==Move::F)
         has_folded[player_to_move]=true;
@@ -91,13 +114,12 @@ void KuhnPoker::execute(Move& action) {
 }
 
 void KuhnPoker::undo() {
+    TRACE_SCOPE("undo");
     player_to_move=(player_to_move-1+players)%players;
-    Move last_action = history[0];
+    UndoEntry entry = undo_log.pop();
     history--;
-    if (last_action == Move::F)
-        has_folded[player_to_move] = false;
-    else
-        money_in_hand[player_to_move] = 1.0f;
+    money_in_hand[player_to_move] = entry.money_in_hand;
+    has_folded[player_to_move] = entry.has_folded;
 }
 
 bool KuhnPoker::is_finished() {
@@ -138,27 +160,28 @@ std::vector<Move>& KuhnPoker::get_actions(std::vector<Move>& actions) {
         actions.emplace_back(Move::R);
     else
         actions.emplace_back(Move::F);
-    actions_for_infoset[get_current_infoset()] = actions;
+    if (infoset_observer != nullptr)
+        infoset_observer->observe(player_to_move, get_current_infoset(), actions);
     return actions;
 }
 
+inline int KuhnPoker::get_max_actions() {
+    return 2;
+}
+
 Move KuhnPoker::get_random_action() {
     std::vector<Move> actions;
     actions.reserve(MAX_MOVES);
     actions = get_actions(actions);
-    return actions[rand()%actions.size()];
+    return actions[random_engine()%actions.size()];
 }
 
 inline Move KuhnPoker::sample_action() {
     throw std::runtime_error("Kuhn poker cannot sample action.");
 }
 
-inline std::set<uint64_t> KuhnPoker::get_encountered_infosets(int player) {
-    return encountered_infosets[player];
-}
-
-std::vector<Move> KuhnPoker::get_actions_from_infoset(uint64_t infoset) {
-    assertm(actions_for_infoset.find(infoset) != actions_for_infoset.end(), "Infoset is encountered before.");
-    return actions_for_infoset[infoset];
+std::unique_ptr<Game> KuhnPoker::clone() {
+    std::unique_ptr<Game> game(new KuhnPoker(*this));
+    game->set_infoset_observer(nullptr);
+    return game;
 }
-
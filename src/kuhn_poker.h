@@ -2,6 +2,7 @@
 #define KUHN_POKER_H
 
 #include "game.h"
+#include "undo_log.h"
 #include <unordered_map>
 
 
@@ -12,9 +13,14 @@ class KuhnPoker: public Game {
         KuhnPoker();
         KuhnPoker(int);
         void reset_game();
+        void reset_game(Rng&);
         inline int get_num_players();
         inline int get_player_to_move();
         inline uint64_t get_infoset(int);
+        inline uint64_t get_public_state();
+        inline int get_private_state(int);
+        inline int get_num_private_states();
+        void set_private_state(int, int);
         inline uint64_t get_current_infoset();
         inline bool is_player_to_move(int);
         inline bool is_player_in_hand(int);
@@ -25,12 +31,17 @@ class KuhnPoker: public Game {
         bool is_finished();
         float get_outcome_for_player(int);
         std::vector<Move>& get_actions(std::vector<Move>&);
+        inline int get_max_actions();
         Move get_random_action();
         inline Move sample_action();
-        std::set<uint64_t> get_encountered_infosets(int);
-        std::vector<Move> get_actions_from_infoset(uint64_t);
+        std::unique_ptr<Game> clone();
 
     private:
+        struct UndoEntry {
+            float money_in_hand;
+            bool has_folded;
+        };
+
         int players;
         int player_to_move;
         History history;
@@ -38,11 +49,10 @@ class KuhnPoker: public Game {
         std::vector<Cards> card_for_player;
         std::vector<float> money_in_hand;
         std::vector<bool> has_folded;
-        std::vector<std::set<uint64_t>> encountered_infosets;
-        std::unordered_map<uint64_t, std::vector<Move>> actions_for_infoset;
+        UndoLog<UndoEntry> undo_log;
 
-        void initialize_hand();
-        void draw_cards();
+        void initialize_hand(Rng&);
+        void draw_cards(Rng&);
         Cards find_best_remaining_hand();
 };
 
@@ -1,89 +1,284 @@
-#include "game.h"
-#include "kuhn_poker.h"
+#include "lcfr.h"
+#include "public_tree.h"
+#include "quantized.h"
+#include "trace.h"
 #include <vector>
 #include <algorithm>
-#include "../lib/robin_hood.h"
 
-namespace lcfr {
+LCFR::LCFR(RegretStorage storage, uint32_t seed) : storage{storage}, nodes_visited{0}, terminal_evaluations{0}, iterations{0}, seed{seed}, rng{seed}, telemetry{nullptr} {}
 
-    robin_hood::unordered_map<uint64_t, robin_hood::unordered_map<Move, float>> regret, cumulative_strategy;
+void LCFR::clear() {
+    regret.clear();
+    cumulative_strategy.clear();
+    tree.clear();
+    blocks.clear();
+    nodes_visited = 0;
+    terminal_evaluations = 0;
+    iterations = 0;
+    rng.seed(seed);
+}
 
-    robin_hood::unordered_map<uint64_t, robin_hood::unordered_map<Move, float>> calculate_cumulative_strategy() {
-        robin_hood::unordered_map<uint64_t, robin_hood::unordered_map<Move, float>> strategy;
-        for (auto const [infoset, infoset_cumulative_strategies] : cumulative_strategy) {
-            float sum = 0.0f;
-            for (auto const [action, action_cumulative_strategy] : infoset_cumulative_strategies)
-                sum += action_cumulative_strategy;
-            for (auto const [action, action_cumulative_strategy] : infoset_cumulative_strategies)
-                strategy[infoset][action] = action_cumulative_strategy/sum;
-        }
-        return strategy;
+Node* LCFR::get_root() {
+    return storage == RegretStorage::TREE ? tree.get_root() : nullptr;
+}
+
+inline Node* LCFR::get_child(Node* node, int x) {
+    return node == nullptr ? nullptr : tree.get_child(node, x);
+}
+
+inline void LCFR::find_rows(Game& game, TraversalFrame& frame) {
+    // The rows of the private state of the player to move, in the tree node or in the block of the
+    // public state. A block is sized when its public state is first reached.
+    if (storage == RegretStorage::TREE) {
+        int private_state = game.get_private_state(frame.player);
+        frame.regret = frame.node->infoset_regret[private_state];
+        frame.strategy = frame.node->infoset_strategy[private_state];
+    } else if (storage == RegretStorage::BLOCK) {
+        Block& block = blocks[game.get_public_state()];
+        if (block.num_actions == 0)
+            block.resize(game.get_num_private_states(), frame.actions.size());
+        assertm(block.num_actions == frame.actions.size(), "The actions of a public state are the same for every private state.");
+        int private_state = game.get_private_state(frame.player);
+        frame.regret = block.get_regret(private_state);
+        frame.strategy = block.get_strategy(private_state);
+    } else {
+        frame.regret = nullptr;
+        frame.strategy = nullptr;
     }
+}
+
+inline float& LCFR::get_regret(float* row, uint64_t infoset, int x, Move action) {
+    return row == nullptr ? regret[infoset][action] : row[x];
+}
 
-    void calculate_strategy(Game& game, std::vector<Move>& actions, uint64_t infoset, std::vector<float>& probabilities) {
-        float sum=0.0f;
-        for (int x=0; x<actions.size(); ++x)
-            sum += std::max(regret[infoset][actions[x]], 0.0f);
-        for (int x=0; x<actions.size(); ++x)
-            //strategy_profile[infoset][actions[x]] = (sum>0.0f) ? regret[infoset][actions[x]]/sum : 1.0f/static_cast<float>(actions.size());
-            probabilities[x] = (sum>0.0f) ? std::max(regret[infoset][actions[x]], 0.0f)/sum : 1.0f/static_cast<float>(actions.size());
+inline float& LCFR::get_cumulative_strategy(float* row, uint64_t infoset, int x, Move action) {
+    return row == nullptr ? cumulative_strategy[infoset][action] : row[x];
+}
+
+robin_hood::unordered_map<uint64_t, robin_hood::unordered_map<Move, float>> LCFR::calculate_cumulative_strategy() {
+    robin_hood::unordered_map<uint64_t, robin_hood::unordered_map<Move, float>> strategy;
+    for (auto const [infoset, infoset_cumulative_strategies] : cumulative_strategy) {
+        float sum = 0.0f;
+        for (auto const [action, action_cumulative_strategy] : infoset_cumulative_strategies)
+            sum += action_cumulative_strategy;
+        for (auto const [action, action_cumulative_strategy] : infoset_cumulative_strategies)
+            strategy[infoset][action] = action_cumulative_strategy/sum;
     }
+    return strategy;
+}
 
-    float lcfr (Game& game, int player, int timestep, std::vector<float>& player_reach_prob, double pos_pow, double neg_pow, double strat_pow) {
-        if (game.is_finished()) {
-            //std::cout << infoset_to_string(game.get_infoset(0)) << " " << infoset_to_string(game.get_infoset(1)) << " " << player << " " << game.get_outcome_for_player(player) << std::endl;
-            return game.get_outcome_for_player(player);
-        } else if (game.is_chance_node()) {
-            Move action = game.sample_action();
-            game.execute(action);
-            float outcome = lcfr(game, player, timestep, player_reach_prob, pos_pow, neg_pow, strat_pow);
+robin_hood::unordered_map<uint64_t, robin_hood::unordered_map<Move, float>> LCFR::calculate_cumulative_strategy(Game& game) {
+    if (storage == RegretStorage::TREE)
+        return public_tree::normalize_strategy(game, tree);
+    if (storage == RegretStorage::BLOCK)
+        return public_tree::normalize_strategy(game, blocks);
+    return calculate_cumulative_strategy();
+}
+
+void LCFR::calculate_strategy(float* row, std::vector<Move>& actions, uint64_t infoset, std::vector<float>& probabilities) {
+    TRACE_SCOPE("calculate_strategy");
+    float sum=0.0f;
+    for (int x=0; x<actions.size(); ++x)
+        sum += std::max(get_regret(row, infoset, x, actions[x]), 0.0f);
+    for (int x=0; x<actions.size(); ++x)
+        //strategy_profile[infoset][actions[x]] = (sum>0.0f) ? regret[infoset][actions[x]]/sum : 1.0f/static_cast<float>(actions.size());
+        probabilities[x] = (sum>0.0f) ? std::max(get_regret(row, infoset, x, actions[x]), 0.0f)/sum : 1.0f/static_cast<float>(actions.size());
+}
+
+float LCFR::lcfr(Game& game, Node* node, int player, std::vector<float>& player_reach_prob, Discount& discount) {
+    // A frame is entered when the game reaches it, and resumed with the value of its child when
+    // the move to the child is undone. The reach probability of the player to move is restored
+    // before the next action is taken.
+    float value = 0.0f;
+    bool entering = true;
+    stack.start(node);
+    while (!stack.empty()) {
+        TraversalFrame& frame = stack.top();
+        if (entering) {
+            ++nodes_visited;
+            if (game.is_finished()) {
+                TRACE_SCOPE("terminal");
+                ++terminal_evaluations;
+                value = game.get_outcome_for_player(player);
+                stack.pop();
+                entering = false;
+                continue;
+            } else if (game.is_chance_node()) {
+                // A public tree has no branches for the chance outcomes.
+                assertm(frame.node == nullptr, "Tree storage is for games without chance nodes.");
+                Move action = game.sample_action();
+                frame.kind = FrameKind::SAMPLED;
+                game.execute(action);
+                stack.push(frame.node);
+                continue;
+            }
+            frame.kind = FrameKind::EXPLORED;
+            frame.player = game.get_player_to_move();
+            frame.infoset = game.get_infoset(frame.player);
+            frame.actions.clear();
+            game.get_actions(frame.actions);
+            assertm(storage != RegretStorage::TREE || frame.actions.size() <= MAX_MOVES, "The storage has room for the actions.");
+            find_rows(game, frame);
+            frame.values.assign(frame.actions.size(), 0.0f);
+            frame.probabilities.assign(frame.actions.size(), 0.0f);
+            calculate_strategy(frame.regret, frame.actions, frame.infoset, frame.probabilities);
+            frame.action = -1;
+            frame.expected_value = 0.0f;
+            frame.prior_reach_prob = player_reach_prob[frame.player];
+        } else {
             game.undo();
-            return outcome;
+            if (frame.kind == FrameKind::SAMPLED) {
+                stack.pop();
+                continue;
+            }
+            player_reach_prob[frame.player] = frame.prior_reach_prob;
+            frame.values[frame.action] = value;
+            frame.expected_value += frame.probabilities[frame.action] * value;
         }
-        float expected_value = 0.0f;
-        int current_player = game.get_player_to_move();
-        uint64_t infoset = game.get_infoset(current_player);
-        std::vector<Move> actions;
-        actions.reserve(MAX_MOVES);
-        game.get_actions(actions);
-        std::vector<float> lcfr_value(actions.size(), 0.0f);
-        std::vector<float> infoset_strategy(actions.size(), 0.0f);
-        calculate_strategy(game, actions, infoset, infoset_strategy);
-        for (int x=0; x<actions.size(); ++x) {
-            float prior_player_reach_prob = player_reach_prob[current_player];
-            player_reach_prob[current_player] *= infoset_strategy[x];
-            game.execute(actions[x]);
-            float outcome = lcfr(game, player, timestep, player_reach_prob, pos_pow, neg_pow, strat_pow);
-            game.undo();
-            player_reach_prob[current_player] = prior_player_reach_prob;
-            lcfr_value[x] = outcome;
-            expected_value += infoset_strategy[x] * outcome;
+
+        if (++frame.action < frame.actions.size()) {
+            player_reach_prob[frame.player] = frame.prior_reach_prob * frame.probabilities[frame.action];
+            game.execute(frame.actions[frame.action]);
+            entering = true;
+            stack.push(get_child(frame.node, frame.action));
+            continue;
         }
-        if (player == current_player) {
+        if (player == frame.player) {
+            TRACE_SCOPE("regret_update");
             float reach_prob = 1.0f;
             for (int x=0; x<game.get_num_players(); ++x)
                 if (x!=player)
                     reach_prob *= player_reach_prob[x];
-            double pos_disc = std::pow((double)(timestep + 1), pos_pow)/(std::pow((double)(timestep + 1), pos_pow) + 1.0);
-            double neg_disc = std::pow((double)(timestep + 1), neg_pow)/(std::pow((double)(timestep + 1), neg_pow) + 1.0);
-            double strat_disc = std::pow((double)(timestep + 1)/(double)(timestep + 2), strat_pow);
-            for (int x=0; x<actions.size(); ++x) {
-                regret[infoset][actions[x]] += reach_prob * (lcfr_value[x] - expected_value);
-                regret[infoset][actions[x]]*= regret[infoset][actions[x]] > 0.0f ? pos_disc:neg_disc;
-                cumulative_strategy[infoset][actions[x]] += player_reach_prob[player] * infoset_strategy[x];
-                cumulative_strategy[infoset][actions[x]] *= strat_disc;
+            for (int x=0; x<frame.actions.size(); ++x) {
+                float& action_regret = get_regret(frame.regret, frame.infoset, x, frame.actions[x]);
+                action_regret = discount.update_regret(action_regret, reach_prob * (frame.values[x] - frame.expected_value));
+                float& action_cumulative_strategy = get_cumulative_strategy(frame.strategy, frame.infoset, x, frame.actions[x]);
+                action_cumulative_strategy = discount.update_strategy(action_cumulative_strategy, player_reach_prob[player] * frame.probabilities[x]);
             }
         }
-        return expected_value;
+        value = frame.expected_value;
+        stack.pop();
+        entering = false;
     }
+    return value;
+}
 
-    void search(int timesteps, Game& game) {
-        for (int timestep=0; timestep<timesteps; ++timestep) {
-            for (int player=0; player<game.get_num_players(); ++player) {
-                game.reset_game();
-                std::vector<float> player_reach_prob(game.get_num_players(), 1.0f);
-                lcfr(game, player, timestep, player_reach_prob, 1.5, 0.5, 3.0);
-            }
+size_t LCFR::get_num_infosets() {
+    // A node or block holds the infosets of every private state, whether they are reached or not.
+    if (storage == RegretStorage::TREE)
+        return tree.size() * MAX_CARDS;
+    if (storage == RegretStorage::BLOCK) {
+        size_t num_infosets = 0;
+        for (auto const& [public_state, block]:blocks)
+            num_infosets += block.get_num_private_states();
+        return num_infosets;
+    }
+    return regret.size();
+}
+
+size_t LCFR::get_memory_usage() {
+    if (storage == RegretStorage::TREE)
+        return tree.size() * sizeof(Node);
+    if (storage == RegretStorage::BLOCK) {
+        size_t memory = get_table_memory(blocks);
+        for (auto const& [public_state, block]:blocks)
+            memory += (block.regret.capacity() + block.strategy.capacity()) * sizeof(float);
+        return memory;
+    }
+    size_t memory = get_table_memory(regret) + get_table_memory(cumulative_strategy);
+    for (auto const& [infoset, infoset_regret]:regret)
+        memory += get_table_memory(infoset_regret);
+    for (auto const& [infoset, infoset_cumulative_strategy]:cumulative_strategy)
+        memory += get_table_memory(infoset_cumulative_strategy);
+    return memory;
+}
+
+SolverStatistics LCFR::get_statistics(int timestep) {
+    // Nothing is pruned, and the rates are filled in by the telemetry.
+    return SolverStatistics{timestep, iterations, nodes_visited, terminal_evaluations, 0, get_num_infosets(), get_memory_usage(), 0.0, 0.0, 0.0};
+}
+
+void LCFR::set_telemetry(Telemetry* new_telemetry) {
+    telemetry = new_telemetry;
+    if (telemetry != nullptr)
+        telemetry->start(iterations, nodes_visited);
+}
+
+void LCFR::save_checkpoint(Checkpointer& checkpointer, int timestep) {
+    // The state is serialized from a snapshot, so the solver goes on training while it is written.
+    checkpointer.write([this, timestep](std::vector<char>& buffer) {
+        checkpoint::write_header(buffer, checkpoint::Solver::LCFR, timestep);
+        checkpoint::write_random_engine(buffer, rng);
+        checkpoint::write<RegretStorage>(buffer, storage);
+        if (storage == RegretStorage::TREE) {
+            checkpoint::write_tree(buffer, tree);
+        } else if (storage == RegretStorage::BLOCK) {
+            checkpoint::write_blocks(buffer, blocks);
+        } else {
+            checkpoint::write_table(buffer, regret);
+            checkpoint::write_table(buffer, cumulative_strategy);
         }
+    });
+}
+
+int LCFR::load_checkpoint(Checkpointer& checkpointer) {
+    std::vector<char> buffer = checkpointer.read();
+    checkpoint::Reader reader(buffer);
+    int timestep = checkpoint::read_header(reader, checkpoint::Solver::LCFR);
+    checkpoint::read_random_engine(reader, rng);
+    storage = checkpoint::read_storage(reader);
+    if (storage == RegretStorage::TREE) {
+        checkpoint::read_tree(reader, tree);
+    } else if (storage == RegretStorage::BLOCK) {
+        checkpoint::read_blocks(reader, blocks);
+    } else {
+        checkpoint::read_table(reader, regret);
+        checkpoint::read_table(reader, cumulative_strategy);
     }
+    return timestep;
+}
+
+void LCFR::train(int first_timestep, int timesteps, Game& game, CFRVariant variant, Checkpointer* checkpointer, int checkpoint_interval) {
+    assertm(storage != RegretStorage::TREE || game.get_num_private_states() <= MAX_CARDS, "Tree storage has room for the private states.");
+    assertm(storage != RegretStorage::TREE || game.get_max_actions() <= MAX_MOVES, "The storage has room for the actions.");
+    for (int timestep=first_timestep; timestep<timesteps; ++timestep) {
+        TRACE_SCOPE("iteration");
+        // The discounts only depend on the timestep, so they are calculated once per iteration.
+        Discount discount = variant.get_discount(timestep);
+        for (int player=0; player<game.get_num_players(); ++player) {
+            game.reset_game(rng);
+            std::vector<float> player_reach_prob(game.get_num_players(), 1.0f);
+            lcfr(game, get_root(), player, player_reach_prob, discount);
+        }
+        ++iterations;
+        if (telemetry != nullptr && telemetry->is_due())
+            telemetry->report(get_statistics(timestep + 1));
+        if (checkpointer != nullptr && (timestep + 1)%checkpoint_interval == 0 && timestep + 1 < timesteps && !checkpointer->is_writing())
+            save_checkpoint(*checkpointer, timestep + 1);
+    }
+}
+
+void LCFR::search(int timesteps, Game& game, CFRVariant variant) {
+    train(0, timesteps, game, variant, nullptr, 0);
+}
+
+void LCFR::search(int timesteps, Game& game, CFRVariant variant, Checkpointer& checkpointer, int checkpoint_interval) {
+    // The variant is not part of the checkpoint, so a resumed search has to be given the same one.
+    int first_timestep = checkpointer.exists() ? load_checkpoint(checkpointer) : 0;
+    train(first_timestep, timesteps, game, variant, &checkpointer, checkpoint_interval);
+    if (first_timestep < timesteps)
+        save_checkpoint(checkpointer, timesteps);
+    checkpointer.wait();
+}
+
+void LCFR::search(int timesteps, Game& game) {
+    search(timesteps, game, cfr_variants::discounted(1.5, 0.5, 3.0));
+}
+
+AnytimeResult LCFR::search(Game& game, CFRVariant variant, SearchBudget budget) {
+    // Runs iterations from timestep 0 until the budget is exhausted, and returns the average strategy so far.
+    SearchStatistics statistics = anytime::run(budget, nodes_visited, [this, &game, &variant](int timestep) {
+        train(timestep, timestep + 1, game, variant, nullptr, 0);
+    });
+    return AnytimeResult{calculate_cumulative_strategy(game), statistics};
 }
@@ -0,0 +1,76 @@
+#ifndef LCFR_H
+#define LCFR_H
+
+#include <vector>
+#include <cstdint>
+#include <random>
+#include "game.h"
+#include "cfr_variants.h"
+#include "tree.h"
+#include "checkpoint.h"
+#include "anytime.h"
+#include "telemetry.h"
+#include "traversal.h"
+#include "../lib/robin_hood.h"
+
+class LCFR {
+    /*
+        Full-width CFR with the discounts of a CFR variant, discounted CFR when none is given. A
+        solver owns its regrets, cumulative strategy and random engine, so several solvers can run
+        in one process, each on its own thread.
+    */
+    public:
+        robin_hood::unordered_map<uint64_t, robin_hood::unordered_map<Move, float>> regret, cumulative_strategy;
+
+        // With tree storage, the regrets are found by walking a public tree alongside the game
+        // instead of hashing the infoset. With block storage, they are found by hashing the public
+        // state. Both keep the regrets of all private states of a public state together; a tree
+        // node has room for MAX_CARDS of them, and a block for every private state of the game.
+        RegretStorage storage;
+        Tree tree;
+        BlockTable blocks;
+
+        // The number of nodes that are traversed, for the statistics of the anytime search and
+        // the telemetry, and the other totals of the telemetry.
+        uint64_t nodes_visited;
+        uint64_t terminal_evaluations;
+        int iterations;
+
+        // The random engine deals the hands. It starts from the seed again when the solver is
+        // cleared, and is saved with the checkpoints.
+        uint32_t seed;
+        Rng rng;
+
+        LCFR(RegretStorage storage = RegretStorage::HASH_MAP, uint32_t seed = std::random_device()());
+        void clear();
+        robin_hood::unordered_map<uint64_t, robin_hood::unordered_map<Move, float>> calculate_cumulative_strategy();
+        robin_hood::unordered_map<uint64_t, robin_hood::unordered_map<Move, float>> calculate_cumulative_strategy(Game&);
+        // Traverses with an explicit stack of frames, so the depth is not limited by the stack of the thread.
+        float lcfr(Game&, Node*, int, std::vector<float>&, Discount&);
+        size_t get_num_infosets();
+        size_t get_memory_usage();
+        SolverStatistics get_statistics(int);
+        // The telemetry is given reports during training until it is set to nullptr.
+        void set_telemetry(Telemetry*);
+        void save_checkpoint(Checkpointer&, int);
+        int load_checkpoint(Checkpointer&);
+        void search(int, Game&, CFRVariant);
+        void search(int, Game&, CFRVariant, Checkpointer&, int);
+        void search(int, Game&);
+        AnytimeResult search(Game&, CFRVariant, SearchBudget);
+        // Runs the timesteps from the first one up to the last one, so a run can be continued.
+        void train(int, int, Game&, CFRVariant, Checkpointer*, int);
+
+    private:
+        Node* get_root();
+        Node* get_child(Node*, int);
+        void find_rows(Game&, TraversalFrame&);
+        float& get_regret(float*, uint64_t, int, Move);
+        float& get_cumulative_strategy(float*, uint64_t, int, Move);
+        void calculate_strategy(float*, std::vector<Move>&, uint64_t, std::vector<float>&);
+
+        Telemetry* telemetry;
+        TraversalStack stack;
+};
+
+#endif
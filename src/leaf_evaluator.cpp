@@ -0,0 +1,108 @@
+#include "leaf_evaluator.h"
+#include "hash.h"
+
+LeafEvaluator::LeafEvaluator(robin_hood::unordered_map<uint64_t, robin_hood::unordered_map<Move, float>>& blueprint, float bias, int num_rollouts, uint32_t seed) : blueprint{blueprint}, bias{bias}, num_rollouts{num_rollouts}, cache_hits{0}, cache_misses{0} {
+    rng.seed(seed);
+}
+
+void LeafEvaluator::calculate_blueprint_strategy(robin_hood::unordered_map<uint64_t, robin_hood::unordered_map<Move, float>>& blueprint, uint64_t infoset, std::vector<Move>& actions, int continuation, float bias, std::vector<float>& probabilities) {
+    // Infosets and actions that the blueprint does not know about are played uniformly.
+    auto infoset_strategy = blueprint.find(infoset);
+    float sum = 0.0f;
+    for (int x=0; x<actions.size(); ++x) {
+        float probability = 1.0f;
+        if (infoset_strategy != blueprint.end()) {
+            auto action_probability = infoset_strategy->second.find(actions[x]);
+            probability = action_probability == infoset_strategy->second.end() ? 0.0f : action_probability->second;
+        }
+        if ((continuation == 1 && actions[x] == Move::F) || (continuation == 2 && actions[x] == Move::C) || (continuation == 3 && is_raise(actions[x])))
+            probability *= bias;
+        probabilities[x] = probability;
+        sum += probability;
+    }
+    for (int x=0; x<actions.size(); ++x)
+        probabilities[x] = (sum>0.0f) ? probabilities[x]/sum : 1.0f/static_cast<float>(actions.size());
+}
+
+uint64_t LeafEvaluator::get_key(Game& game, std::vector<int>& continuation) {
+    uint64_t key = game.get_public_state();
+    for (int player=0; player<game.get_num_players(); ++player)
+        key = hash_combine(hash_combine(key, game.get_private_state(player)), continuation[player]);
+    return key;
+}
+
+float LeafEvaluator::evaluate(Game& game, int player, std::vector<int>& continuation) {
+    uint64_t key = get_key(game, continuation);
+    auto cached = cache.find(key);
+    if (cached != cache.end()) {
+        ++cache_hits;
+        return cached->second[player];
+    }
+    ++cache_misses;
+    std::vector<float>& values = cache[key];
+    values.assign(game.get_num_players(), 0.0f);
+    rollout(game, continuation, num_rollouts, values);
+    for (float& value:values)
+        value /= static_cast<float>(num_rollouts);
+    return values[player];
+}
+
+void LeafEvaluator::rollout(Game& game, std::vector<int>& continuation, int batch_size, std::vector<float>& values) {
+    // Adds the outcomes of batch_size rollouts from the current state to the values.
+    if (game.is_finished()) {
+        for (int player=0; player<game.get_num_players(); ++player)
+            values[player] += static_cast<float>(batch_size) * game.get_outcome_for_player(player);
+        return;
+    } else if (game.is_chance_node()) {
+        // Every rollout of the batch deals its own outcome, so the batch goes on one rollout at a time.
+        for (int x=0; x<batch_size; ++x) {
+            game.resample_chance(rng);
+            Move action = game.sample_action();
+            game.execute(action);
+            rollout(game, continuation, 1, values);
+            game.undo();
+        }
+        return;
+    }
+    int current_player = game.get_player_to_move();
+    std::vector<Move> actions;
+    actions.reserve(MAX_MOVES);
+    game.get_actions(actions);
+    std::vector<float> probabilities(actions.size());
+    calculate_blueprint_strategy(blueprint, game.get_infoset(current_player), actions, continuation[current_player], bias, probabilities);
+
+    std::vector<int> batch_sizes(actions.size(), 0);
+    for (int x=0; x<batch_size; ++x) {
+        float r = static_cast<float>(rng()) / static_cast<float>(Rng::MAX);
+        int action = 0;
+        float cumulative_probability = probabilities[0];
+        while (r >= cumulative_probability && action + 1 < actions.size())
+            cumulative_probability += probabilities[++action];
+        ++batch_sizes[action];
+    }
+    for (int x=0; x<actions.size(); ++x) {
+        if (batch_sizes[x] == 0)
+            continue;
+        game.execute(actions[x]);
+        rollout(game, continuation, batch_sizes[x], values);
+        game.undo();
+    }
+}
+
+void LeafEvaluator::clear() {
+    cache.clear();
+    cache_hits = 0;
+    cache_misses = 0;
+}
+
+size_t LeafEvaluator::get_cache_size() {
+    return cache.size();
+}
+
+uint64_t LeafEvaluator::get_cache_hits() {
+    return cache_hits;
+}
+
+uint64_t LeafEvaluator::get_cache_misses() {
+    return cache_misses;
+}
@@ -0,0 +1,48 @@
+#ifndef LEAF_EVALUATOR_H
+#define LEAF_EVALUATOR_H
+
+#include <vector>
+#include <cstdint>
+#include "game.h"
+#include "rng.h"
+#include "../lib/robin_hood.h"
+
+class LeafEvaluator {
+    /*
+        Values the leaves of a depth-limited subgame by rolling out the rest of the hand, with
+        every player following the continuation strategy it chose: the blueprint (0), or the
+        blueprint biased towards folding (1), calling (2) or raising (3).
+
+        The rollouts of a leaf are run as one batch. The blueprint probabilities of a node are
+        looked up once per batch, and the batch is split over the actions by sampling. At a chance
+        node every rollout draws its own outcome, so the cards to come are left reshuffled. A rollout
+        gives the outcome of every player, so the values of all players are stored together,
+        keyed by the public state, the private states and the continuations. Later visits to the
+        same leaf are answered from the cache.
+
+        An evaluator is used by one thread at a time, and samples with its own random engine.
+    */
+    public:
+        LeafEvaluator(robin_hood::unordered_map<uint64_t, robin_hood::unordered_map<Move, float>>&, float, int, uint32_t);
+        float evaluate(Game&, int, std::vector<int>&);
+        void clear();
+        size_t get_cache_size();
+        uint64_t get_cache_hits();
+        uint64_t get_cache_misses();
+
+        static void calculate_blueprint_strategy(robin_hood::unordered_map<uint64_t, robin_hood::unordered_map<Move, float>>&, uint64_t, std::vector<Move>&, int, float, std::vector<float>&);
+
+    private:
+        robin_hood::unordered_map<uint64_t, robin_hood::unordered_map<Move, float>>& blueprint;
+        float bias;
+        int num_rollouts;
+        Rng rng;
+        robin_hood::unordered_node_map<uint64_t, std::vector<float>> cache;
+        uint64_t cache_hits;
+        uint64_t cache_misses;
+
+        uint64_t get_key(Game&, std::vector<int>&);
+        void rollout(Game&, std::vector<int>&, int, std::vector<float>&);
+};
+
+#endif
@@ -1,208 +1,448 @@
-#include "game.h"
-#include "kuhn_poker.h"
+#include "mccfr.h"
+#include "public_tree.h"
+#include "trace.h"
 #include <vector>
 #include <stdlib.h>
 #include <utility>
 #include <string>
 #include <algorithm>
-#include "../lib/robin_hood.h"
 
 
-namespace mccfr {
+MCCFR::MCCFR(RegretStorage storage, uint32_t seed) : storage{storage}, nodes_visited{0}, terminal_evaluations{0}, pruned_branches{0}, iterations{0}, seed{seed}, rng{seed}, telemetry{nullptr} {}
 
-    robin_hood::unordered_map<uint64_t, robin_hood::unordered_map<Move, float>> regret, strategy;
+void MCCFR::clear() {
+    // Keeps the storage and the quantization, so a cleared solver trains the same way again.
+    regret.clear();
+    strategy.clear();
+    tree.clear();
+    quantized.clear();
+    nodes_visited = 0;
+    terminal_evaluations = 0;
+    pruned_branches = 0;
+    iterations = 0;
+    rng.seed(seed);
+}
+
+Node* MCCFR::get_root() {
+    return storage == RegretStorage::TREE ? tree.get_root() : nullptr;
+}
+
+inline Node* MCCFR::get_child(Node* node, int x) {
+    return node == nullptr ? nullptr : tree.get_child(node, x);
+}
+
+inline int MCCFR::get_private_state(Game& game, Node* node, int player) {
+    // A tree node holds one row of regrets for every private state of the player.
+    return node == nullptr ? 0 : game.get_private_state(player);
+}
+
+inline float MCCFR::get_prune_threshold() {
+    // Quantized regrets never go below the floor, so their threshold is scaled with it.
+    return storage == RegretStorage::QUANTIZED ? quantization.get_prune_threshold() : -300000000.0f;
+}
+
+inline float MCCFR::get_regret(TraversalFrame& frame, int x) {
+    if (frame.node != nullptr)
+        return frame.node->infoset_regret[frame.private_state][x];
+    if (frame.record != nullptr)
+        return quantization.dequantize(frame.record->regret[x]);
+    return regret[frame.infoset][frame.actions[x]];
+}
 
-    robin_hood::unordered_map<uint64_t, robin_hood::unordered_map<Move, float>> calculate_probabilities() {
-        robin_hood::unordered_map<uint64_t, robin_hood::unordered_map<Move, float>> probabilities;
-        for (auto const [infoset, infoset_regret]:regret) {
+inline void MCCFR::set_regret(TraversalFrame& frame, int x, float value) {
+    if (frame.node != nullptr)
+        frame.node->infoset_regret[frame.private_state][x] = value;
+    else if (frame.record != nullptr)
+        frame.record->regret[x] = quantization.quantize(value);
+    else
+        regret[frame.infoset][frame.actions[x]] = value;
+}
+
+inline void MCCFR::add_strategy(TraversalFrame& frame, int x, float value) {
+    if (frame.node != nullptr)
+        frame.node->infoset_strategy[frame.private_state][x] += value;
+    else if (frame.record != nullptr)
+        frame.record->add_strategy(x, value);
+    else
+        strategy[frame.infoset][frame.actions[x]] = strategy[frame.infoset][frame.actions[x]] + value;
+}
+
+robin_hood::unordered_map<uint64_t, robin_hood::unordered_map<Move, float>> MCCFR::calculate_probabilities() {
+    // Infosets that have regrets but no strategy yet are played uniformly.
+    robin_hood::unordered_map<uint64_t, robin_hood::unordered_map<Move, float>> probabilities;
+    if (storage == RegretStorage::QUANTIZED) {
+        quantized.for_each([&probabilities](uint64_t infoset, QuantizedInfoset& record) {
             float sum = 0;
-            for (auto const [action, action_regret]:infoset_regret) {
-                sum += strategy[infoset][action];
-            }
-            for (auto const [action, action_regret]:infoset_regret) {
-                probabilities[infoset][action] = strategy[infoset][action] / sum;
-            }
-        }
+            for (int x=0; x<record.num_actions; ++x)
+                sum += static_cast<float>(record.strategy[x]);
+            for (int x=0; x<record.num_actions; ++x)
+                probabilities[infoset][static_cast<Move>(record.actions[x])] = sum > 0 ? static_cast<float>(record.strategy[x]) / sum : 1.0f / static_cast<float>(record.num_actions);
+        });
         return probabilities;
-    };
+    }
+    for (auto const [infoset, infoset_regret]:regret) {
+        float sum = 0;
+        for (auto const [action, action_regret]:infoset_regret) {
+            sum += strategy[infoset][action];
+        }
+        for (auto const [action, action_regret]:infoset_regret) {
+            probabilities[infoset][action] = sum > 0 ? strategy[infoset][action] / sum : 1.0f / static_cast<float>(infoset_regret.size());
+        }
+    }
+    return probabilities;
+}
+
+robin_hood::unordered_map<uint64_t, robin_hood::unordered_map<Move, float>> MCCFR::calculate_probabilities(Game& game) {
+    if (storage == RegretStorage::TREE)
+        return public_tree::normalize_strategy(game, tree);
+    return calculate_probabilities();
+}
 
 
 
-    Move sample_action(std::vector<Move>& actions, std::vector<float>& probabilities) {
-        float r = static_cast <float> (rand()) / static_cast <float> (RAND_MAX);
-        float r_copy = r;
-        for (int x=0; x<actions.size(); ++x) {
-            r-=probabilities[x];
-            if (r<=1.0e-7f)
-                return actions[x];
-        }
-        throw std::runtime_error("Could not decide upon an action. the sum of strategies is lower than 1.0.");
+int MCCFR::sample_action(std::vector<Move>& actions, std::vector<float>& probabilities) {
+    float r = static_cast <float> (rng()) / static_cast <float> (Rng::MAX);
+    float r_copy = r;
+    for (int x=0; x<actions.size(); ++x) {
+        r-=probabilities[x];
+        if (r<=1.0e-7f)
+            return x;
     }
+    throw std::runtime_error("Could not decide upon an action. the sum of strategies is lower than 1.0.");
+}
 
-    void calculate_strategy(Game& game, int player, std::vector<Move>& actions, std::vector<float>& probabilities) {
-        if (!game.is_player_to_move(player))
-            throw std::runtime_error("Calculating strategy for wrong player.");
+void MCCFR::calculate_strategy(Game& game, int player, TraversalFrame& frame) {
+    // Fills in the infoset of the frame, whose actions have been set. The quantized record is looked
+    // up here once, so the accesses to the regrets of the node do not go through the table again.
+    TRACE_SCOPE("calculate_strategy");
+    if (!game.is_player_to_move(player))
+        throw std::runtime_error("Calculating strategy for wrong player.");
 
-        uint64_t infoset = game.get_infoset(player);
-        float sum = 0;
-        for (Move action:actions)
-            sum+=std::max(regret[infoset][action], 0.0f);
-        for (int x=0; x<actions.size(); ++x)
-            probabilities.emplace_back(sum > 0 ? std::max(regret[infoset][actions[x]], 0.0f)/sum : 1.0f/static_cast<float>(regret[infoset].size()));
+    frame.infoset = game.get_infoset(player);
+    frame.private_state = get_private_state(game, frame.node, player);
+    frame.record = nullptr;
+    if (frame.node == nullptr && storage == RegretStorage::QUANTIZED) {
+        frame.record = &quantized[frame.infoset];
+        if (frame.record->num_actions == 0)
+            frame.record->set_actions(frame.actions);
     }
+    frame.probabilities.clear();
+    float sum = 0;
+    for (int x=0; x<frame.actions.size(); ++x)
+        sum+=std::max(get_regret(frame, x), 0.0f);
+    for (int x=0; x<frame.actions.size(); ++x)
+        frame.probabilities.emplace_back(sum > 0 ? std::max(get_regret(frame, x), 0.0f)/sum : 1.0f/static_cast<float>(frame.actions.size()));
+}
 
-    void update_strategy(Game& game, int player) {
-        if (game.is_finished() || !game.is_player_in_hand(player) || game.betting_round() > 0) {
-            return;
-        } else if (game.is_chance_node()) {
-            Move action = game.sample_action();
-            game.execute(action);
-            update_strategy(game, player);
-            game.undo();
-        } else if (game.is_player_to_move(player)) {
-            uint64_t infoset = game.get_infoset(player);
-            std::vector<Move> actions;
-            actions.reserve(MAX_MOVES);
-            actions = game.get_actions(actions);
-            std::vector<float> probabilities;
-            probabilities.reserve(MAX_MOVES);
-            calculate_strategy(game, player, actions, probabilities);
-            Move action = sample_action(actions, probabilities);
-            strategy[infoset][action] = strategy[infoset][action] + 1;
-
-            game.execute(action);
-            update_strategy(game, player);
-            game.undo();
-        } else {
-            std::vector<Move> actions;
-            actions.reserve(MAX_MOVES);
-            actions = game.get_actions(actions);
-            for (Move action:actions) {
+inline void MCCFR::get_actions(Game& game, std::vector<Move>& actions) {
+    actions.clear();
+    game.get_actions(actions);
+    assertm(storage == RegretStorage::HASH_MAP || actions.size() <= MAX_MOVES, "The storage has room for the actions.");
+}
+
+void MCCFR::update_strategy(Game& game, Node* node, int player) {
+    // Samples an action where the player is to move and expands the actions of the others. A
+    // frame is entered when the game reaches it, and resumed when the move of its child is undone.
+    bool entering = true;
+    stack.start(node);
+    while (!stack.empty()) {
+        TraversalFrame& frame = stack.top();
+        if (entering) {
+            ++nodes_visited;
+            if (game.is_finished() || !game.is_player_in_hand(player) || game.betting_round() > 0) {
+                stack.pop();
+                entering = false;
+                continue;
+            } else if (game.is_chance_node()) {
+                // A public tree has no branches for the chance outcomes.
+                assertm(frame.node == nullptr, "Tree storage is for games without chance nodes.");
+                Move action = game.sample_action();
+                frame.kind = FrameKind::SAMPLED;
                 game.execute(action);
-                update_strategy(game, player);
-                game.undo();
+                stack.push(frame.node);
+                continue;
+            } else if (game.is_player_to_move(player)) {
+                get_actions(game, frame.actions);
+                calculate_strategy(game, player, frame);
+                frame.kind = FrameKind::SAMPLED;
+                frame.action = sample_action(frame.actions, frame.probabilities);
+                add_strategy(frame, frame.action, 1.0f);
+
+                game.execute(frame.actions[frame.action]);
+                stack.push(get_child(frame.node, frame.action));
+                continue;
+            }
+            get_actions(game, frame.actions);
+            frame.kind = FrameKind::EXPLORED;
+            frame.action = -1;
+        } else {
+            game.undo();
+            if (frame.kind == FrameKind::SAMPLED) {
+                stack.pop();
+                continue;
             }
         }
+        if (++frame.action < frame.actions.size()) {
+            game.execute(frame.actions[frame.action]);
+            entering = true;
+            stack.push(get_child(frame.node, frame.action));
+        } else {
+            stack.pop();
+            entering = false;
+        }
     }
+}
 
-    float traverse_mccfr(Game& game, int player, bool prune) {
-        if (game.is_finished()) {
-            return game.get_outcome_for_player(player);
-        } else if (!game.is_player_in_hand(player)) {
-            // TODO: It is possible that we can skip the recursion.
-            Move action = game.get_random_action();
+float MCCFR::traverse_mccfr(Game& game, Node* node, int player, bool prune) {
+    // The value of the frame that was left last is handed to its parent, which is resumed after
+    // the move to the child is undone.
+    float prune_threshold = get_prune_threshold();
+    float value = 0.0f;
+    bool entering = true;
+    stack.start(node);
+    while (!stack.empty()) {
+        TraversalFrame& frame = stack.top();
+        if (entering) {
+            ++nodes_visited;
+            if (game.is_finished()) {
+                TRACE_SCOPE("terminal");
+                ++terminal_evaluations;
+                value = game.get_outcome_for_player(player);
+                stack.pop();
+                entering = false;
+                continue;
+            } else if (!game.is_player_in_hand(player)) {
+                // TODO: It is possible that we can skip the traversal.
+                get_actions(game, frame.actions);
+                frame.kind = FrameKind::SAMPLED;
+                frame.action = rng()%frame.actions.size();
 
-            game.execute(action);
-            float outcome = traverse_mccfr(game, player, prune);
-            game.undo();
-            return outcome;
-        } else if (game.is_chance_node()) {
-            Move action = game.sample_action();
+                game.execute(frame.actions[frame.action]);
+                stack.push(get_child(frame.node, frame.action));
+                continue;
+            } else if (game.is_chance_node()) {
+                // A public tree has no branches for the chance outcomes.
+                assertm(frame.node == nullptr, "Tree storage is for games without chance nodes.");
+                Move action = game.sample_action();
+                frame.kind = FrameKind::SAMPLED;
+                game.execute(action);
+                stack.push(frame.node);
+                continue;
+            } else if (!game.is_player_to_move(player)) {
+                get_actions(game, frame.actions);
+                calculate_strategy(game, game.get_player_to_move(), frame);
+                frame.kind = FrameKind::SAMPLED;
+                frame.action = sample_action(frame.actions, frame.probabilities);
 
-            game.execute(action);
-            float outcome = traverse_mccfr(game, player, prune);
-            game.undo();
-            return outcome;
-        } else if (game.is_player_to_move(player)) {
-            uint64_t infoset = game.get_infoset(player);
-            std::vector<Move> actions;
-            actions.reserve(MAX_MOVES);
-            actions = game.get_actions(actions);
-            std::vector<float> probabilities;
-            probabilities.reserve(MAX_MOVES);
-            calculate_strategy(game, player, actions, probabilities);
-
-            float expected_value = 0;
-            std::vector<float> outcomes(actions.size(), 0.0f);
-            std::vector<bool> explored(actions.size(), false);
-            for (int x=0; x<actions.size(); ++x) {
-                if (!prune || regret[infoset][actions[x]] > -300000000.0f) {
-                    explored[x] = true;
-                    game.execute(actions[x]);
-                    float outcome = traverse_mccfr(game, player, prune);
-                    game.undo();
-                    expected_value += probabilities[x] * outcome;
-                    outcomes[x] = outcome;
-                }
+                game.execute(frame.actions[frame.action]);
+                stack.push(get_child(frame.node, frame.action));
+                continue;
             }
-            for (int x=0; x<actions.size(); ++x) {
-                if (!prune || explored[x])
-                    regret[infoset][actions[x]] = regret[infoset][actions[x]] + outcomes[x] - expected_value;
-            }
-            return expected_value;
+            get_actions(game, frame.actions);
+            calculate_strategy(game, player, frame);
+            frame.kind = FrameKind::EXPLORED;
+            frame.action = -1;
+            frame.expected_value = 0.0f;
+            frame.values.assign(frame.actions.size(), 0.0f);
+            frame.explored.assign(frame.actions.size(), false);
         } else {
-            std::vector<Move> actions;
-            actions.reserve(MAX_MOVES);
-            actions = game.get_actions(actions);
-            std::vector<float> probabilities;
-            probabilities.reserve(MAX_MOVES);
-            calculate_strategy(game, game.get_player_to_move(), actions, probabilities);
-            Move action = sample_action(actions, probabilities);
-
-            game.execute(action);
-            float outcome = traverse_mccfr(game, player, prune);
             game.undo();
-            return outcome;
+            if (frame.kind == FrameKind::SAMPLED) {
+                stack.pop();
+                continue;
+            }
+            frame.expected_value += frame.probabilities[frame.action] * value;
+            frame.values[frame.action] = value;
         }
+
+        int next = frame.action + 1;
+        while (next < frame.actions.size() && prune && !(get_regret(frame, next) > prune_threshold)) {
+            ++pruned_branches;
+            ++next;
+        }
+        if (next < frame.actions.size()) {
+            frame.action = next;
+            frame.explored[next] = true;
+            game.execute(frame.actions[next]);
+            entering = true;
+            stack.push(get_child(frame.node, next));
+            continue;
+        }
+        {
+            TRACE_SCOPE("regret_update");
+            for (int x=0; x<frame.actions.size(); ++x) {
+                if (!prune || frame.explored[x])
+                    set_regret(frame, x, get_regret(frame, x) + frame.values[x] - frame.expected_value);
+            }
+        }
+        value = frame.expected_value;
+        stack.pop();
+        entering = false;
     }
+    return value;
+}
 
+size_t MCCFR::get_memory_usage() {
+    if (storage == RegretStorage::TREE)
+        return tree.size() * sizeof(Node);
+    if (storage == RegretStorage::QUANTIZED)
+        return quantized.get_memory();
+    size_t memory = get_table_memory(regret) + get_table_memory(strategy);
+    for (auto const& [infoset, infoset_regret]:regret)
+        memory += get_table_memory(infoset_regret);
+    for (auto const& [infoset, infoset_strategy]:strategy)
+        memory += get_table_memory(infoset_strategy);
+    return memory;
+}
 
-    void mccfr_p(int timesteps, int strategy_interval, int prune_treshold, int lcfr_treshold, int disc_interval, Game& game) {
-        // Optional: set all strategies and rewares to zero.
-        int num_players = game.get_num_players();
-        for (int timestep = 0; timestep < timesteps; ++timestep){
-            for (int player=0; player<num_players; ++player) {
-                game.reset_game();
-                if (timestep%strategy_interval==0) {
-                    update_strategy(game, player);
-                }
-                if (timestep>prune_treshold) {
-                    float r = static_cast <float> (rand()) / static_cast <float> (RAND_MAX);
-                    if (r < 0.05) {
-                        traverse_mccfr(game, player, false);
-                    } else {
-                        traverse_mccfr(game, player, true);
-                    }
+size_t MCCFR::get_num_infosets() {
+    // A tree node holds the infosets of every private state, whether they are reached or not.
+    if (storage == RegretStorage::TREE)
+        return tree.size() * MAX_CARDS;
+    return storage == RegretStorage::QUANTIZED ? quantized.size() : regret.size();
+}
+
+float MCCFR::get_memory_per_infoset() {
+    size_t num_infosets = get_num_infosets();
+    return num_infosets == 0 ? 0.0f : static_cast<float>(get_memory_usage()) / static_cast<float>(num_infosets);
+}
+
+SolverStatistics MCCFR::get_statistics(int timestep) {
+    // The rates are filled in by the telemetry.
+    return SolverStatistics{timestep, iterations, nodes_visited, terminal_evaluations, pruned_branches, get_num_infosets(), get_memory_usage(), 0.0, 0.0, 0.0};
+}
+
+void MCCFR::set_telemetry(Telemetry* new_telemetry) {
+    telemetry = new_telemetry;
+    if (telemetry != nullptr)
+        telemetry->start(iterations, nodes_visited);
+}
+
+void MCCFR::save_checkpoint(Checkpointer& checkpointer, int timestep) {
+    // The state is serialized from a snapshot, so the solver goes on training while it is written.
+    checkpointer.write([this, timestep](std::vector<char>& buffer) {
+        checkpoint::write_header(buffer, checkpoint::Solver::MCCFR, timestep);
+        checkpoint::write_random_engine(buffer, rng);
+        checkpoint::write<RegretStorage>(buffer, storage);
+        if (storage == RegretStorage::TREE) {
+            checkpoint::write_tree(buffer, tree);
+        } else if (storage == RegretStorage::QUANTIZED) {
+            checkpoint::write<RegretQuantization>(buffer, quantization);
+            checkpoint::write_records(buffer, quantized);
+        } else {
+            checkpoint::write_table(buffer, regret);
+            checkpoint::write_table(buffer, strategy);
+        }
+    });
+}
+
+int MCCFR::load_checkpoint(Checkpointer& checkpointer) {
+    std::vector<char> buffer = checkpointer.read();
+    checkpoint::Reader reader(buffer);
+    int timestep = checkpoint::read_header(reader, checkpoint::Solver::MCCFR);
+    checkpoint::read_random_engine(reader, rng);
+    storage = checkpoint::read_storage(reader);
+    if (storage == RegretStorage::TREE) {
+        checkpoint::read_tree(reader, tree);
+    } else if (storage == RegretStorage::QUANTIZED) {
+        quantization = checkpoint::read<RegretQuantization>(reader);
+        if (!quantization.is_valid())
+            throw std::runtime_error("The checkpoint has an invalid quantization.");
+        checkpoint::read_records(reader, quantized);
+    } else {
+        checkpoint::read_table(reader, regret);
+        checkpoint::read_table(reader, strategy);
+    }
+    return timestep;
+}
+
+void MCCFR::train(int first_timestep, int timesteps, int strategy_interval, int prune_treshold, int lcfr_treshold, int disc_interval, Game& game, Checkpointer* checkpointer, int checkpoint_interval) {
+    assertm(storage != RegretStorage::TREE || game.get_num_private_states() <= MAX_CARDS, "Tree storage has room for the private states.");
+    assertm(storage == RegretStorage::HASH_MAP || game.get_max_actions() <= MAX_MOVES, "The storage has room for the actions.");
+    int num_players = game.get_num_players();
+    for (int timestep = first_timestep; timestep < timesteps; ++timestep){
+        TRACE_SCOPE("iteration");
+        for (int player=0; player<num_players; ++player) {
+            game.reset_game(rng);
+            if (timestep%strategy_interval==0) {
+                update_strategy(game, get_root(), player);
+            }
+            if (timestep>prune_treshold) {
+                float r = static_cast <float> (rng()) / static_cast <float> (Rng::MAX);
+                if (r < 0.05) {
+                    traverse_mccfr(game, get_root(), player, false);
                 } else {
-                    traverse_mccfr(game, player, false);
+                    traverse_mccfr(game, get_root(), player, true);
                 }
+            } else {
+                traverse_mccfr(game, get_root(), player, false);
             }
-            if (timestep < lcfr_treshold && timestep%disc_interval==0) {
-                float d = (static_cast <float> (timestep)/static_cast <float> (disc_interval) ) / ((static_cast <float> (timestep)/static_cast <float> (disc_interval) + 1.0f));
-                for (int player=0; player<num_players; ++player) {
-                    // Info: only getting encountered infosets where it is the player to act.
-                    for (uint64_t infoset:game.get_encountered_infosets(player)) {
-                        for (Move action:game.get_actions_from_infoset(infoset)) {
-                            regret[infoset][action] = regret[infoset][action] * d;
-                            strategy[infoset][action] = strategy[infoset][action] * d;
+        }
+        if (timestep < lcfr_treshold && timestep%disc_interval==0) {
+            float d = (static_cast <float> (timestep)/static_cast <float> (disc_interval) ) / ((static_cast <float> (timestep)/static_cast <float> (disc_interval) + 1.0f));
+            if (storage == RegretStorage::TREE) {
+                tree.for_each_node([d](Node& node) {
+                    for (int card=0; card<MAX_CARDS; ++card)
+                        for (int x=0; x<MAX_MOVES; ++x) {
+                            node.infoset_regret[card][x] *= d;
+                            node.infoset_strategy[card][x] *= d;
                         }
-                    }
-                }
+                });
+            } else if (storage == RegretStorage::QUANTIZED) {
+                quantized.for_each([d](uint64_t infoset, QuantizedInfoset& record) {
+                    for (int x=0; x<record.num_actions; ++x)
+                        record.regret[x] = static_cast<int32_t>(std::lround(record.regret[x] * static_cast<double>(d)));
+                    record.discount_strategy(d);
+                });
+            } else {
+                // The solver's own tables are discounted, so a resumed run discounts the same
+                // infosets as an uninterrupted one.
+                for (auto& [infoset, infoset_regret]:regret)
+                    for (auto& [action, action_regret]:infoset_regret)
+                        action_regret = action_regret * d;
+                for (auto& [infoset, infoset_strategy]:strategy)
+                    for (auto& [action, action_strategy]:infoset_strategy)
+                        action_strategy = action_strategy * d;
             }
         }
+        ++iterations;
+        if (telemetry != nullptr && telemetry->is_due())
+            telemetry->report(get_statistics(timestep + 1));
+        // A checkpoint is skipped while the previous one is still being written, so the
+        // traversals never wait for the disk. The last timestep is saved by the caller.
+        if (checkpointer != nullptr && (timestep + 1)%checkpoint_interval == 0 && timestep + 1 < timesteps && !checkpointer->is_writing())
+            save_checkpoint(*checkpointer, timestep + 1);
     }
 }
 
-void print_strategy() {
-    for (auto const [infoset, infoset_regret]:mccfr::regret) {
-        std::cout << infoset_to_string(infoset) << ": ";
-        for (auto const [action, regret]:infoset_regret) {
-            std::cout << move_to_char[action] << " " << regret << " " << std::to_string(mccfr::strategy[infoset][action]) << " ";
-        }
-        std::cout << std::endl;
-    }
+void MCCFR::mccfr_p(int timesteps, int strategy_interval, int prune_treshold, int lcfr_treshold, int disc_interval, Game& game) {
+    // Optional: set all strategies and rewares to zero.
+    train(0, timesteps, strategy_interval, prune_treshold, lcfr_treshold, disc_interval, game, nullptr, 0);
 }
 
+void MCCFR::mccfr_p(int timesteps, int strategy_interval, int prune_treshold, int lcfr_treshold, int disc_interval, Game& game, Checkpointer& checkpointer, int checkpoint_interval) {
+    // Resumes from the checkpoint if there is one, and always leaves a checkpoint of the last timestep.
+    int first_timestep = checkpointer.exists() ? load_checkpoint(checkpointer) : 0;
+    train(first_timestep, timesteps, strategy_interval, prune_treshold, lcfr_treshold, disc_interval, game, &checkpointer, checkpoint_interval);
+    if (first_timestep < timesteps)
+        save_checkpoint(checkpointer, timesteps);
+    checkpointer.wait();
+}
 
+AnytimeResult MCCFR::mccfr_p(int strategy_interval, int prune_treshold, int lcfr_treshold, int disc_interval, Game& game, SearchBudget budget) {
+    // Runs iterations from timestep 0 until the budget is exhausted, and returns the average strategy so far.
+    SearchStatistics statistics = anytime::run(budget, nodes_visited, [&](int timestep) {
+        train(timestep, timestep + 1, strategy_interval, prune_treshold, lcfr_treshold, disc_interval, game, nullptr, 0);
+    });
+    return AnytimeResult{calculate_probabilities(game), statistics};
+}
 
-/*
-int main() {
-    KuhnPoker khun_poker;
-
-    auto start = std::chrono::high_resolution_clock::now();
-    mccfr::mccfr_p(100000, 5, 200, 3, 2, khun_poker);
-    auto stop = std::chrono::high_resolution_clock::now();
-    std::cout << std::chrono::duration_cast<std::chrono::microseconds>(stop - start).count() << std::endl;
-    print_strategy();
+void MCCFR::print_strategy() {
+    for (auto const [infoset, infoset_regret]:regret) {
+        std::cout << infoset_to_string(infoset) << ": ";
+        for (auto const [action, action_regret]:infoset_regret) {
+            std::cout << move_to_char[action] << " " << action_regret << " " << std::to_string(strategy[infoset][action]) << " ";
+        }
+        std::cout << std::endl;
+    }
 }
-*/
@@ -0,0 +1,89 @@
+#ifndef MCCFR_H
+#define MCCFR_H
+
+#include <vector>
+#include <cstdint>
+#include <random>
+#include "game.h"
+#include "tree.h"
+#include "checkpoint.h"
+#include "anytime.h"
+#include "telemetry.h"
+#include "quantized.h"
+#include "sharded_table.h"
+#include "traversal.h"
+#include "../lib/robin_hood.h"
+
+class MCCFR {
+    /*
+        Monte Carlo CFR with pruning and linear discounting. A solver owns its regrets and average
+        strategy, so several solvers can train in one process. A solver is used by one thread at a
+        time, and samples from its own random engine.
+    */
+    public:
+        robin_hood::unordered_map<uint64_t, robin_hood::unordered_map<Move, float>> regret, strategy;
+
+        // With tree storage, the regrets are found by walking a public tree alongside the game
+        // instead of hashing the infoset. A node has a row of regrets for every private state, so
+        // it is for games without chance nodes and with at most MAX_CARDS private states.
+        RegretStorage storage;
+        Tree tree;
+
+        // With quantized storage, every infoset is a single record with integer regrets. The records
+        // are sharded, so that the shards can be placed on the NUMA nodes of the threads that use them.
+        ShardedTable<QuantizedInfoset> quantized;
+        RegretQuantization quantization;
+
+        // The number of nodes that are traversed, for the statistics of the anytime search and
+        // the telemetry, and the other totals of the telemetry.
+        uint64_t nodes_visited;
+        uint64_t terminal_evaluations;
+        uint64_t pruned_branches;
+        int iterations;
+
+        // The random engine deals the hands and samples the actions. It starts from the seed again
+        // when the solver is cleared, and is saved with the checkpoints, so that a resumed run
+        // samples the same as one that was not interrupted.
+        uint32_t seed;
+        Rng rng;
+
+        MCCFR(RegretStorage storage = RegretStorage::HASH_MAP, uint32_t seed = std::random_device()());
+        void clear();
+        robin_hood::unordered_map<uint64_t, robin_hood::unordered_map<Move, float>> calculate_probabilities();
+        robin_hood::unordered_map<uint64_t, robin_hood::unordered_map<Move, float>> calculate_probabilities(Game&);
+        Node* get_root();
+        // The traversals use an explicit stack of frames, so their depth is not limited by the
+        // stack of the thread.
+        void update_strategy(Game&, Node*, int);
+        float traverse_mccfr(Game&, Node*, int, bool);
+        size_t get_memory_usage();
+        float get_memory_per_infoset();
+        size_t get_num_infosets();
+        SolverStatistics get_statistics(int);
+        // The telemetry is given reports during training until it is set to nullptr.
+        void set_telemetry(Telemetry*);
+        void save_checkpoint(Checkpointer&, int);
+        int load_checkpoint(Checkpointer&);
+        void mccfr_p(int, int, int, int, int, Game&);
+        void mccfr_p(int, int, int, int, int, Game&, Checkpointer&, int);
+        AnytimeResult mccfr_p(int, int, int, int, Game&, SearchBudget);
+        // Runs the timesteps from the first one up to the last one, so a run can be continued.
+        void train(int, int, int, int, int, int, Game&, Checkpointer*, int);
+        void print_strategy();
+
+    private:
+        Node* get_child(Node*, int);
+        int get_private_state(Game&, Node*, int);
+        float get_prune_threshold();
+        float get_regret(TraversalFrame&, int);
+        void set_regret(TraversalFrame&, int, float);
+        void add_strategy(TraversalFrame&, int, float);
+        void get_actions(Game&, std::vector<Move>&);
+        int sample_action(std::vector<Move>&, std::vector<float>&);
+        void calculate_strategy(Game&, int, TraversalFrame&);
+
+        Telemetry* telemetry;
+        TraversalStack stack;
+};
+
+#endif
@@ -0,0 +1,52 @@
+#include "numa_topology.h"
+#include <sched.h>
+#ifdef HAVE_LIBNUMA
+#include <numa.h>
+#endif
+
+namespace numa_topology {
+
+    // The node a thread was pinned to, so that it does not have to be looked up on every access.
+    thread_local int pinned_node = -1;
+    // The node an unpinned thread first ran on. The thread may migrate afterwards, but the node only
+    // decides whether its accesses are counted as local, which does not need to be exact.
+    thread_local int first_node = -1;
+
+    int get_num_nodes() {
+#ifdef HAVE_LIBNUMA
+        if (numa_available() >= 0)
+            return numa_num_configured_nodes();
+#endif
+        return 1;
+    }
+
+    int get_current_node() {
+#ifdef HAVE_LIBNUMA
+        if (numa_available() >= 0) {
+            int node = numa_node_of_cpu(sched_getcpu());
+            return node < 0 ? 0 : node;
+        }
+#endif
+        return 0;
+    }
+
+    void pin_thread_to_node(int node) {
+#ifdef HAVE_LIBNUMA
+        if (numa_available() >= 0 && node < numa_num_configured_nodes()) {
+            numa_run_on_node(node);
+            // Memory is allocated on the node of the thread that first touches it.
+            numa_set_localalloc();
+        }
+#endif
+        pinned_node = node;
+    }
+
+    int get_thread_node() {
+        if (pinned_node >= 0)
+            return pinned_node;
+        if (first_node < 0)
+            first_node = get_current_node();
+        return first_node;
+    }
+
+}
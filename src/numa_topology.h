@@ -0,0 +1,17 @@
+#ifndef NUMA_TOPOLOGY_H
+#define NUMA_TOPOLOGY_H
+
+namespace numa_topology {
+
+    /*
+        The NUMA nodes of the machine, through libnuma when the build found it (HAVE_LIBNUMA).
+        Without libnuma the machine is treated as a single node, and pinning does nothing.
+    */
+    int get_num_nodes();
+    int get_current_node();
+    void pin_thread_to_node(int);
+    int get_thread_node();
+
+}
+
+#endif
@@ -0,0 +1,82 @@
+#include "public_cfr.h"
+#include <algorithm>
+
+void PublicCFR::clear() {
+    tree.clear();
+    deals.clear();
+}
+
+void PublicCFR::calculate_strategy(Node* node, int num_actions, std::array<Range, MAX_MOVES>& strategy) {
+    Range sum{};
+    for (int x=0; x<num_actions; ++x)
+        for (int card=0; card<MAX_CARDS; ++card)
+            sum[card] += std::max(node->infoset_regret[card][x], 0.0f);
+    for (int x=0; x<num_actions; ++x)
+        for (int card=0; card<MAX_CARDS; ++card)
+            strategy[x][card] = (sum[card]>0.0f) ? std::max(node->infoset_regret[card][x], 0.0f)/sum[card] : 1.0f/static_cast<float>(num_actions);
+}
+
+robin_hood::unordered_map<uint64_t, robin_hood::unordered_map<Move, float>> PublicCFR::calculate_cumulative_strategy(Game& game) {
+    return public_tree::normalize_strategy(game, tree);
+}
+
+void PublicCFR::cfr(Game& game, Node* node, int player, std::vector<Range>& reach, Range& values, Discount& discount) {
+    if (game.is_finished()) {
+        public_tree::terminal_values(game, player, reach, deals, values);
+        return;
+    } else if (game.is_chance_node()) {
+        // A public tree has no branches for the chance outcomes. This is thrown instead of
+        // asserted, so that a release build does not solve a sampled outcome instead.
+        throw std::runtime_error("Public CFR is for games without chance nodes.");
+    }
+    int current_player = game.get_player_to_move();
+    std::vector<Move> actions;
+    actions.reserve(MAX_MOVES);
+    game.get_actions(actions);
+    assertm(actions.size() <= MAX_MOVES, "The tree has room for the actions.");
+    std::array<Range, MAX_MOVES> infoset_strategy, action_values;
+    calculate_strategy(node, actions.size(), infoset_strategy);
+
+    Range prior_reach = reach[current_player];
+    values.fill(0.0f);
+    for (int x=0; x<actions.size(); ++x) {
+        for (int card=0; card<MAX_CARDS; ++card)
+            reach[current_player][card] = prior_reach[card] * infoset_strategy[x][card];
+        game.execute(actions[x]);
+        cfr(game, tree.get_child(node, x), player, reach, action_values[x], discount);
+        game.undo();
+        // The values of the opponents' actions are already weighted by their reach probability.
+        for (int card=0; card<MAX_CARDS; ++card)
+            values[card] += (player == current_player) ? infoset_strategy[x][card] * action_values[x][card] : action_values[x][card];
+    }
+    reach[current_player] = prior_reach;
+
+    if (player == current_player) {
+        for (int x=0; x<actions.size(); ++x) {
+            for (int card=0; card<MAX_CARDS; ++card) {
+                node->infoset_regret[card][x] = discount.update_regret(node->infoset_regret[card][x], action_values[x][card] - values[card]);
+                node->infoset_strategy[card][x] = discount.update_strategy(node->infoset_strategy[card][x], prior_reach[card] * infoset_strategy[x][card]);
+            }
+        }
+    }
+}
+
+void PublicCFR::search(int timesteps, Game& game, CFRVariant variant) {
+    assertm(game.get_num_private_states() <= MAX_CARDS, "A range has room for the private states.");
+    assertm(game.get_max_actions() <= MAX_MOVES, "The tree has room for the actions.");
+    deals = public_tree::enumerate_deals(game);
+    for (int timestep=0; timestep<timesteps; ++timestep) {
+        // The discounts are equal for every public state, so they are calculated once per iteration.
+        Discount discount = variant.get_discount(timestep);
+        for (int player=0; player<game.get_num_players(); ++player) {
+            game.reset_game();
+            std::vector<Range> reach(game.get_num_players(), public_tree::uniform_range(game));
+            Range values;
+            cfr(game, tree.get_root(), player, reach, values, discount);
+        }
+    }
+}
+
+void PublicCFR::search(int timesteps, Game& game) {
+    search(timesteps, game, cfr_variants::discounted(1.5, 0.5, 3.0));
+}
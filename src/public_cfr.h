@@ -0,0 +1,32 @@
+#ifndef PUBLIC_CFR_H
+#define PUBLIC_CFR_H
+
+#include <vector>
+#include "game.h"
+#include "cfr_variants.h"
+#include "public_tree.h"
+#include "tree.h"
+#include "../lib/robin_hood.h"
+
+class PublicCFR {
+    /*
+        Full-width CFR over the public tree. Every public state is visited once per iteration and
+        the regrets, strategies and values for all private states of the acting player are updated
+        together, so no private cards are sampled. A solver owns its tree, so several solvers can
+        run in one process.
+    */
+    public:
+        Tree tree;
+        std::vector<int> deals;
+
+        void clear();
+        robin_hood::unordered_map<uint64_t, robin_hood::unordered_map<Move, float>> calculate_cumulative_strategy(Game&);
+        void cfr(Game&, Node*, int, std::vector<Range>&, Range&, Discount&);
+        void search(int, Game&, CFRVariant);
+        void search(int, Game&);
+
+    private:
+        void calculate_strategy(Node*, int, std::array<Range, MAX_MOVES>&);
+};
+
+#endif
@@ -0,0 +1,183 @@
+#include "public_tree.h"
+#include <algorithm>
+#include <limits>
+
+
+namespace public_tree {
+
+    void enumerate_deals_(std::vector<int>& deals, std::vector<int>& deal, std::vector<bool>& dealt, int player) {
+        if (player == deal.size()) {
+            deals.insert(deals.end(), deal.begin(), deal.end());
+            return;
+        }
+        for (int private_state=0; private_state<dealt.size(); ++private_state) {
+            if (dealt[private_state])
+                continue;
+            dealt[private_state] = true;
+            deal[player] = private_state;
+            enumerate_deals_(deals, deal, dealt, player + 1);
+            dealt[private_state] = false;
+        }
+    }
+
+    uint64_t count_deals(Game& game) {
+        // The number of deals that enumerate_deals returns, without enumerating them. It saturates
+        // at the largest value instead of overflowing.
+        uint64_t num_deals = 1;
+        for (int player=0; player<game.get_num_players(); ++player) {
+            uint64_t num_choices = std::max(game.get_num_private_states() - player, 0);
+            if (num_choices != 0 && num_deals > std::numeric_limits<uint64_t>::max() / num_choices)
+                return std::numeric_limits<uint64_t>::max();
+            num_deals *= num_choices;
+        }
+        return num_deals;
+    }
+
+    std::vector<int> enumerate_deals(Game& game) {
+        /*
+            Enumerates every assignment of distinct private states to the players. The deals are
+            stored back to back in a flat vector, with one private state per player.
+        */
+        std::vector<int> deals;
+        std::vector<int> deal(game.get_num_players(), 0);
+        std::vector<bool> dealt(game.get_num_private_states(), false);
+        enumerate_deals_(deals, deal, dealt, 0);
+        return deals;
+    }
+
+    void enumerate_infosets_(Game& game, std::vector<std::vector<uint64_t>>& infosets) {
+        if (game.is_finished())
+            return;
+        if (game.is_chance_node()) {
+            Move action = game.sample_action();
+            game.execute(action);
+            enumerate_infosets_(game, infosets);
+            game.undo();
+            return;
+        }
+        int current_player = game.get_player_to_move();
+        for (int private_state=0; private_state<game.get_num_private_states(); ++private_state) {
+            game.set_private_state(current_player, private_state);
+            infosets[current_player].push_back(game.get_infoset(current_player));
+        }
+        std::vector<Move> actions;
+        actions.reserve(MAX_MOVES);
+        game.get_actions(actions);
+        for (Move action:actions) {
+            game.execute(action);
+            enumerate_infosets_(game, infosets);
+            game.undo();
+        }
+    }
+
+    std::vector<std::vector<uint64_t>> enumerate_infosets(Game& game) {
+        /*
+            Enumerates the infosets of every player in one pass over the public tree, with every
+            private state of the acting player. The infosets of a player are sorted and unique.
+        */
+        std::vector<std::vector<uint64_t>> infosets(game.get_num_players());
+        game.reset_game();
+        enumerate_infosets_(game, infosets);
+        for (std::vector<uint64_t>& player_infosets:infosets) {
+            std::sort(player_infosets.begin(), player_infosets.end());
+            player_infosets.erase(std::unique(player_infosets.begin(), player_infosets.end()), player_infosets.end());
+        }
+        return infosets;
+    }
+
+    Range uniform_range(Game& game) {
+        Range range{};
+        for (int private_state=0; private_state<game.get_num_private_states(); ++private_state)
+            range[private_state] = 1.0f;
+        return range;
+    }
+
+    void terminal_values(Game& game, int player, std::vector<Range>& reach, std::vector<int>& deals, Range& values) {
+        /*
+            Calculates the counterfactual value of a terminal public state for every private state
+            of the player. Each deal is weighted by its chance probability and the reach probability
+            of the opponents.
+        */
+        int num_players = game.get_num_players();
+        float chance_prob = static_cast<float>(num_players) / static_cast<float>(deals.size());
+        values.fill(0.0f);
+        for (int deal=0; deal<deals.size(); deal+=num_players) {
+            float reach_prob = chance_prob;
+            for (int opponent=0; opponent<num_players; ++opponent)
+                if (opponent != player)
+                    reach_prob *= reach[opponent][deals[deal + opponent]];
+            if (reach_prob == 0.0f)
+                continue;
+            for (int x=0; x<num_players; ++x)
+                game.set_private_state(x, deals[deal + x]);
+            values[deals[deal + player]] += reach_prob * game.get_outcome_for_player(player);
+        }
+    }
+
+    template <typename Rows>
+    void normalize_node(Game& game, Rows rows, std::vector<Move>& actions, robin_hood::unordered_map<uint64_t, robin_hood::unordered_map<Move, float>>& strategy) {
+        // The rows give the cumulative strategy of a private state, in the order of the actions.
+        int current_player = game.get_player_to_move();
+        for (int card=0; card<game.get_num_private_states(); ++card) {
+            game.set_private_state(current_player, card);
+            uint64_t infoset = game.get_infoset(current_player);
+            const float* row = rows(card);
+            float sum = 0.0f;
+            for (int x=0; x<actions.size(); ++x)
+                sum += row[x];
+            for (int x=0; x<actions.size(); ++x)
+                strategy[infoset][actions[x]] = (sum>0.0f) ? row[x]/sum : 1.0f/static_cast<float>(actions.size());
+        }
+    }
+
+    void normalize_strategy_(Game& game, Tree& tree, Node* node, robin_hood::unordered_map<uint64_t, robin_hood::unordered_map<Move, float>>& strategy) {
+        if (game.is_finished())
+            return;
+        std::vector<Move> actions;
+        actions.reserve(MAX_MOVES);
+        game.get_actions(actions);
+        normalize_node(game, [node](int card) { return node->infoset_strategy[card]; }, actions, strategy);
+        for (int x=0; x<actions.size(); ++x) {
+            game.execute(actions[x]);
+            normalize_strategy_(game, tree, tree.get_child(node, x), strategy);
+            game.undo();
+        }
+    }
+
+    robin_hood::unordered_map<uint64_t, robin_hood::unordered_map<Move, float>> normalize_strategy(Game& game, Tree& tree) {
+        /*
+            Converts the cumulative strategies that are stored in the tree to the probabilities of
+            every infoset, using the same format as the hash map based solvers.
+        */
+        robin_hood::unordered_map<uint64_t, robin_hood::unordered_map<Move, float>> strategy;
+        game.reset_game();
+        if (tree.size() > 1)
+            normalize_strategy_(game, tree, tree.get_root(), strategy);
+        return strategy;
+    }
+
+    void normalize_strategy_(Game& game, BlockTable& blocks, robin_hood::unordered_map<uint64_t, robin_hood::unordered_map<Move, float>>& strategy) {
+        if (game.is_finished())
+            return;
+        std::vector<Move> actions;
+        actions.reserve(MAX_MOVES);
+        game.get_actions(actions);
+        auto block = blocks.find(game.get_public_state());
+        if (block != blocks.end())
+            normalize_node(game, [&block](int card) { return block->second.get_strategy(card); }, actions, strategy);
+        for (int x=0; x<actions.size(); ++x) {
+            game.execute(actions[x]);
+            normalize_strategy_(game, blocks, strategy);
+            game.undo();
+        }
+    }
+
+    robin_hood::unordered_map<uint64_t, robin_hood::unordered_map<Move, float>> normalize_strategy(Game& game, BlockTable& blocks) {
+        // The same as for a tree, with the block of a public state found by its key instead of by walking the tree.
+        robin_hood::unordered_map<uint64_t, robin_hood::unordered_map<Move, float>> strategy;
+        game.reset_game();
+        if (!blocks.empty())
+            normalize_strategy_(game, blocks, strategy);
+        return strategy;
+    }
+}
@@ -0,0 +1,26 @@
+#ifndef PUBLIC_TREE_H
+#define PUBLIC_TREE_H
+
+#include <array>
+#include <vector>
+#include "game.h"
+#include "tree.h"
+#include "../lib/robin_hood.h"
+
+// A value or reach probability for every private state of one player, stored contiguously so
+// that the loops over private states are vectorized.
+typedef std::array<float, MAX_CARDS> Range;
+
+namespace public_tree {
+
+    uint64_t count_deals(Game&);
+    std::vector<int> enumerate_deals(Game&);
+    std::vector<std::vector<uint64_t>> enumerate_infosets(Game&);
+    Range uniform_range(Game&);
+    void terminal_values(Game&, int, std::vector<Range>&, std::vector<int>&, Range&);
+    robin_hood::unordered_map<uint64_t, robin_hood::unordered_map<Move, float>> normalize_strategy(Game&, Tree&);
+    robin_hood::unordered_map<uint64_t, robin_hood::unordered_map<Move, float>> normalize_strategy(Game&, BlockTable&);
+
+}
+
+#endif
@@ -0,0 +1,96 @@
+#ifndef QUANTIZED_H
+#define QUANTIZED_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include "game.h"
+
+// The average strategy counters are floats unless the build defines COMPACT_STRATEGY, which
+// halves them to 16 bits. The counters of an infoset are halved together when one would overflow.
+#ifdef COMPACT_STRATEGY
+typedef uint16_t strategy_counter_type;
+#else
+typedef float strategy_counter_type;
+#endif
+
+struct RegretQuantization {
+    /*
+        Regrets are stored as round(regret * scale) in 32-bit integers and never go below the
+        floor, which is given in regret units. Pluribus used a floor of -310 000 000, just below
+        the pruning threshold. The floor has to be representable after scaling, so a larger scale
+        needs a higher floor; the pruning threshold follows the floor.
+    */
+    float scale;
+    float floor;
+
+    RegretQuantization(float scale = 1.0f, float floor = -310000000.0f) : scale{scale}, floor{floor} {
+        assertm(is_valid(), "The scaled floor fits in the quantized regrets.");
+    }
+
+    inline bool is_valid() const {
+        return scale > 0.0f && floor < 0.0f && static_cast<double>(floor) * scale >= static_cast<double>(std::numeric_limits<int32_t>::min());
+    }
+
+    inline int32_t quantize(float regret) const {
+        double value = std::round(static_cast<double>(regret) * scale);
+        return static_cast<int32_t>(std::clamp(value, static_cast<double>(floor) * scale, static_cast<double>(std::numeric_limits<int32_t>::max())));
+    }
+
+    inline float dequantize(int32_t regret) const {
+        return static_cast<float>(regret) / scale;
+    }
+
+    inline float get_prune_threshold() const {
+        // The threshold is at the same fraction of the floor as in Pluribus, -300 000 000 of -310 000 000.
+        return floor * (300.0f / 310.0f);
+    }
+};
+
+struct QuantizedInfoset {
+    // The actions are referred to by their position in the list of legal actions.
+    int32_t regret[MAX_MOVES];
+    strategy_counter_type strategy[MAX_MOVES];
+    uint8_t actions[MAX_MOVES];
+    uint8_t num_actions;
+
+    inline void set_actions(std::vector<Move>& legal_actions) {
+        assertm(legal_actions.size() <= MAX_MOVES, "The record has room for the actions.");
+        num_actions = legal_actions.size();
+        for (int x=0; x<num_actions; ++x)
+            actions[x] = static_cast<uint8_t>(legal_actions[x]);
+    }
+
+    inline void add_strategy(int action, float value) {
+        if constexpr (std::is_integral<strategy_counter_type>::value) {
+            float limit = static_cast<float>(std::numeric_limits<strategy_counter_type>::max());
+            while (strategy[action] + value > limit)
+                for (int x=0; x<MAX_MOVES; ++x)
+                    strategy[x] /= 2;
+            strategy[action] += static_cast<strategy_counter_type>(std::lround(value));
+        } else {
+            strategy[action] += value;
+        }
+    }
+
+    inline void discount_strategy(float discount) {
+        for (int x=0; x<MAX_MOVES; ++x)
+            if constexpr (std::is_integral<strategy_counter_type>::value)
+                strategy[x] = static_cast<strategy_counter_type>(std::lround(strategy[x] * discount));
+            else
+                strategy[x] = strategy[x] * discount;
+    }
+};
+
+template <typename Map>
+size_t get_table_memory(const Map& table) {
+    // An estimate of the bytes held by a robin_hood map: one info byte per bucket, and the elements
+    // either in the buckets or behind a pointer in each bucket.
+    size_t num_buckets = table.empty() ? 0 : table.mask() + 1;
+    if (Map::is_flat)
+        return sizeof(Map) + num_buckets * (sizeof(typename Map::value_type) + 1);
+    return sizeof(Map) + num_buckets * (sizeof(void*) + 1) + table.size() * sizeof(typename Map::value_type);
+}
+
+#endif
@@ -0,0 +1,62 @@
+#ifndef RNG_H
+#define RNG_H
+
+#include <array>
+#include <cstdint>
+
+class Rng {
+    /*
+        The additive feedback generator behind glibc's srand/rand, with the state kept in the
+        object instead of in libc. Seeded runs give the same sequence as before, and the state
+        can be saved and restored.
+    */
+    public:
+        static constexpr int DEGREE = 31;
+        static constexpr int SEPARATION = 3;
+        static constexpr uint32_t MAX = 2147483647;
+
+        std::array<int32_t, DEGREE> state;
+        int front;
+        int rear;
+
+        Rng() {
+            seed(1);
+        }
+
+        Rng(uint32_t initial_seed) {
+            seed(initial_seed);
+        }
+
+        void seed(uint32_t initial_seed) {
+            if (initial_seed == 0)
+                initial_seed = 1;
+            state[0] = initial_seed;
+            int32_t word = initial_seed;
+            for (int x=1; x<DEGREE; ++x) {
+                int64_t hi = word / 127773;
+                int64_t lo = word % 127773;
+                word = static_cast<int32_t>(16807 * lo - 2836 * hi);
+                if (word < 0)
+                    word += 2147483647;
+                state[x] = word;
+            }
+            front = SEPARATION;
+            rear = 0;
+            for (int x=0; x<10*DEGREE; ++x)
+                (*this)();
+        }
+
+        inline uint32_t operator()() {
+            uint32_t value = static_cast<uint32_t>(state[front]) + static_cast<uint32_t>(state[rear]);
+            state[front] = value;
+            front = (front + 1) % DEGREE;
+            rear = (rear + 1) % DEGREE;
+            return value >> 1;
+        }
+
+        static constexpr uint32_t max() {
+            return MAX;
+        }
+};
+
+#endif
@@ -0,0 +1,192 @@
+#ifndef SHARDED_TABLE_H
+#define SHARDED_TABLE_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "numa_topology.h"
+#include "quantized.h"
+#include "../lib/robin_hood.h"
+
+struct AccessCounts {
+    uint64_t local;
+    uint64_t remote;
+};
+
+namespace sharded_table {
+
+    // The threads count their accesses in slots of their own. More threads than slots share them.
+    constexpr int MAX_THREAD_SLOTS = 64;
+    constexpr int MAX_BACKOFF = 64;
+
+    inline int get_thread_slot() {
+        static std::atomic<int> next_slot{0};
+        thread_local int slot = next_slot.fetch_add(1, std::memory_order_relaxed) % MAX_THREAD_SLOTS;
+        return slot;
+    }
+
+    inline void pause() {
+        // Tells the core that it is spinning, so that it does not hog the resources of a sibling thread.
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#else
+        std::this_thread::yield();
+#endif
+    }
+
+}
+
+template <typename T>
+class ShardedTable {
+    /*
+        A hash table split into shards that each have their own lock and live on one NUMA node.
+        A key always goes to the same shard, picked from the top bits of a multiplicative hash so
+        that the shards do not share the bits the shard tables index with.
+
+        place_on_nodes spreads the shards round-robin over the nodes. Every shard is allocated
+        and first touched by a thread pinned to its node, so its memory ends up on that node.
+        Threads that are pinned to the same node as a shard access it locally; the accesses
+        from other nodes are counted as remote. Every thread counts on a cache line of its own,
+        and the counts are summed when they are read.
+
+        The values are stored in nodes, so references to them stay valid when a shard grows.
+        Iterating and clearing are not thread-safe.
+    */
+    public:
+        ShardedTable(int num_shards = 1) : counters(new AccessCounter[sharded_table::MAX_THREAD_SLOTS]) {
+            resize(num_shards);
+        }
+
+        void resize(int num_shards) {
+            shard_bits = 0;
+            while ((1 << shard_bits) < num_shards)
+                ++shard_bits;
+            shards.clear();
+            for (int shard=0; shard<(1 << shard_bits); ++shard)
+                shards.emplace_back(new Shard(0));
+        }
+
+        void place_on_nodes(int num_nodes = numa_topology::get_num_nodes()) {
+            for (int shard=0; shard<shards.size(); ++shard) {
+                int node = shard % num_nodes;
+                std::thread([this, shard, node]() {
+                    numa_topology::pin_thread_to_node(node);
+                    // The values are copied, so that their nodes are allocated on the new node as well.
+                    std::unique_ptr<Shard> placed_shard(new Shard(node));
+                    placed_shard->table.reserve(shards[shard]->table.size());
+                    for (auto const& [key, value]:shards[shard]->table)
+                        placed_shard->table.emplace(key, value);
+                    shards[shard] = std::move(placed_shard);
+                }).join();
+            }
+        }
+
+        inline int get_shard(uint64_t key) {
+            return shard_bits == 0 ? 0 : static_cast<int>((key * 0x9e3779b97f4a7c15ULL) >> (64 - shard_bits));
+        }
+
+        inline int get_node(int shard) {
+            return shards[shard]->node;
+        }
+
+        inline int get_num_shards() {
+            return shards.size();
+        }
+
+        inline T& operator[](uint64_t key) {
+            Shard& shard = *shards[get_shard(key)];
+            AccessCounter& counter = counters[sharded_table::get_thread_slot()];
+            if (numa_topology::get_thread_node() == shard.node)
+                counter.local.fetch_add(1, std::memory_order_relaxed);
+            else
+                counter.remote.fetch_add(1, std::memory_order_relaxed);
+            lock(shard);
+            T& value = shard.table[key];
+            shard.locked.store(false, std::memory_order_release);
+            return value;
+        }
+
+        AccessCounts get_access_counts() {
+            AccessCounts counts{0, 0};
+            for (int slot=0; slot<sharded_table::MAX_THREAD_SLOTS; ++slot) {
+                counts.local += counters[slot].local.load(std::memory_order_relaxed);
+                counts.remote += counters[slot].remote.load(std::memory_order_relaxed);
+            }
+            return counts;
+        }
+
+        size_t size() {
+            size_t num_values = 0;
+            for (std::unique_ptr<Shard>& shard:shards)
+                num_values += shard->table.size();
+            return num_values;
+        }
+
+        bool empty() {
+            return size() == 0;
+        }
+
+        size_t get_memory() {
+            size_t memory = 0;
+            for (std::unique_ptr<Shard>& shard:shards)
+                memory += sizeof(Shard) + get_table_memory(shard->table);
+            return memory;
+        }
+
+        void reserve(size_t num_values) {
+            for (std::unique_ptr<Shard>& shard:shards)
+                shard->table.reserve(num_values / shards.size() + 1);
+        }
+
+        void clear() {
+            for (std::unique_ptr<Shard>& shard:shards)
+                shard->table.clear();
+            for (int slot=0; slot<sharded_table::MAX_THREAD_SLOTS; ++slot) {
+                counters[slot].local.store(0, std::memory_order_relaxed);
+                counters[slot].remote.store(0, std::memory_order_relaxed);
+            }
+        }
+
+        template <typename Function>
+        void for_each(Function function) {
+            for (std::unique_ptr<Shard>& shard:shards)
+                for (auto& [key, value]:shard->table)
+                    function(key, value);
+        }
+
+    private:
+        struct alignas(64) Shard {
+            robin_hood::unordered_node_map<uint64_t, T> table;
+            std::atomic<bool> locked{false};
+            int node;
+
+            Shard(int node) : node{node} {}
+        };
+
+        struct alignas(64) AccessCounter {
+            std::atomic<uint64_t> local{0};
+            std::atomic<uint64_t> remote{0};
+        };
+
+        int shard_bits;
+        std::vector<std::unique_ptr<Shard>> shards;
+        std::unique_ptr<AccessCounter[]> counters;
+
+        inline void lock(Shard& shard) {
+            // The waiting threads only read the lock until it looks free, so they do not take its
+            // cache line away from the owner, and back off exponentially between the reads.
+            int backoff = 1;
+            while (shard.locked.exchange(true, std::memory_order_acquire)) {
+                while (shard.locked.load(std::memory_order_relaxed)) {
+                    for (int x=0; x<backoff; ++x)
+                        sharded_table::pause();
+                    backoff = std::min(backoff * 2, sharded_table::MAX_BACKOFF);
+                }
+            }
+        }
+};
+
+#endif
@@ -0,0 +1,297 @@
+#include "subgame_search.h"
+#include "public_tree.h"
+#include "leaf_evaluator.h"
+#include <algorithm>
+#include <memory>
+#include <thread>
+#include <cassert>
+
+#define assertm(exp, msg) assert(((void)msg, exp))
+
+namespace subgame_search {
+
+    constexpr int NUM_SHARDS = 64;
+
+    inline int sample(Rng& rng, std::vector<float>& probabilities) {
+        float r = static_cast<float>(rng()) / static_cast<float>(Rng::MAX);
+        float cumulative_probability = 0.0f;
+        for (int x=0; x<probabilities.size(); ++x) {
+            cumulative_probability += probabilities[x];
+            if (r < cumulative_probability)
+                return x;
+        }
+        return probabilities.size() - 1;
+    }
+
+    void calculate_strategy(SubgameInfoset& data, std::vector<float>& probabilities) {
+        // The number of actions is given by the size of the probabilities.
+        float sum = 0.0f;
+        for (int x=0; x<probabilities.size(); ++x)
+            sum += std::max(data.regret[x].load(std::memory_order_relaxed), 0.0f);
+        for (int x=0; x<probabilities.size(); ++x)
+            probabilities[x] = (sum>0.0f) ? std::max(data.regret[x].load(std::memory_order_relaxed), 0.0f)/sum : 1.0f/static_cast<float>(probabilities.size());
+    }
+
+    template <typename Update>
+    inline void atomic_update(std::atomic<float>& value, Update update) {
+        // Retries until no other thread changed the value in between, so no update is lost.
+        float expected = value.load(std::memory_order_relaxed);
+        while (!value.compare_exchange_weak(expected, update(expected), std::memory_order_relaxed));
+    }
+
+    void update(SubgameInfoset& data, std::vector<float>& probabilities, std::vector<float>& values, float expected_value, float reach_prob, float player_reach_prob, Discount& discount) {
+        for (int x=0; x<probabilities.size(); ++x) {
+            float instant_regret = reach_prob * (values[x] - expected_value);
+            atomic_update(data.regret[x], [&](float regret) { return discount.update_regret(regret, instant_regret); });
+            float weight = player_reach_prob * probabilities[x];
+            atomic_update(data.strategy[x], [&](float strategy) { return discount.update_strategy(strategy, weight); });
+        }
+    }
+
+    // The last reach probability is the weight of the deal of the traversal, which is part of
+    // both the reach of the opponents and the reach that the strategy of the player is averaged with.
+    inline float get_opponent_reach(int player, std::vector<float>& player_reach_prob) {
+        float reach_prob = 1.0f;
+        for (int x=0; x<player_reach_prob.size(); ++x)
+            if (x != player)
+                reach_prob *= player_reach_prob[x];
+        return reach_prob;
+    }
+
+    inline float get_player_reach(int player, std::vector<float>& player_reach_prob) {
+        return player_reach_prob[player] * player_reach_prob.back();
+    }
+
+    void sample_deal(Game& game, Rng& rng) {
+        // Deals distinct private states uniformly, and deals again until they can be dealt together.
+        int num_players = game.get_num_players();
+        std::vector<int> private_states(num_players);
+        do {
+            for (int x=0; x<num_players; ++x) {
+                do
+                    private_states[x] = rng() % game.get_num_private_states();
+                while (std::find(private_states.begin(), private_states.begin() + x, private_states[x]) != private_states.begin() + x);
+                game.set_private_state(x, private_states[x]);
+            }
+        } while (!game.is_valid_deal());
+    }
+
+    float calculate_reach(Game& game, const std::vector<Move>& history, robin_hood::unordered_map<uint64_t, robin_hood::unordered_map<Move, float>>& blueprint) {
+        /*
+            The probability that the blueprint played the actions of the hand so far with the
+            private states that are set, or 0 when they can not be dealt together. The history is
+            undone and replayed, which deals the same cards again, so the game ends up in the
+            same state as it started in.
+        */
+        if (!game.is_valid_deal())
+            return 0.0f;
+        for (int x=0; x<history.size(); ++x)
+            game.undo();
+        std::vector<Move> actions;
+        actions.reserve(MAX_MOVES);
+        std::vector<float> probabilities;
+        float reach_prob = 1.0f;
+        for (Move action:history) {
+            if (!game.is_chance_node()) {
+                actions.clear();
+                game.get_actions(actions);
+                probabilities.resize(actions.size());
+                LeafEvaluator::calculate_blueprint_strategy(blueprint, game.get_current_infoset(), actions, 0, 1.0f, probabilities);
+                reach_prob *= probabilities[std::find(actions.begin(), actions.end(), action) - actions.begin()];
+            }
+            game.execute(action);
+        }
+        return reach_prob;
+    }
+
+    std::vector<float> calculate_beliefs(Game& game, const std::vector<Move>& history, robin_hood::unordered_map<uint64_t, robin_hood::unordered_map<Move, float>>& blueprint, std::vector<int>& deals) {
+        /*
+            The probability of every deal, given that the actions of the hand so far were played by
+            the blueprint. The private states of the game are set back when they are done.
+        */
+        int num_players = game.get_num_players();
+        std::vector<int> private_states(num_players);
+        for (int x=0; x<num_players; ++x)
+            private_states[x] = game.get_private_state(x);
+
+        std::vector<float> beliefs(deals.size()/num_players, 0.0f);
+        float sum = 0.0f;
+        for (int deal=0; deal<beliefs.size(); ++deal) {
+            for (int x=0; x<num_players; ++x)
+                game.set_private_state(x, deals[deal*num_players + x]);
+            beliefs[deal] = calculate_reach(game, history, blueprint);
+            sum += beliefs[deal];
+        }
+        assertm(sum > 0.0f, "The history is possible under the blueprint.");
+        for (float& belief:beliefs)
+            belief /= sum;
+
+        for (int x=0; x<num_players; ++x)
+            game.set_private_state(x, private_states[x]);
+        return beliefs;
+    }
+}
+
+SubgameSearch::SubgameSearch(uint32_t seed) : infosets(subgame_search::NUM_SHARDS), continuations(subgame_search::NUM_SHARDS), rng{seed} {}
+
+void SubgameSearch::clear() {
+    infosets.clear();
+    continuations.clear();
+}
+
+float SubgameSearch::leaf(Game& game, int player, int chooser, std::vector<int>& continuation, std::vector<float>& player_reach_prob, Discount& discount, LeafEvaluator& evaluator, SearchConfig& config) {
+    if (chooser == game.get_num_players()) {
+        return evaluator.evaluate(game, player, continuation);
+    } else if (!game.is_player_in_hand(chooser)) {
+        continuation[chooser] = 0;
+        return leaf(game, player, chooser + 1, continuation, player_reach_prob, discount, evaluator, config);
+    }
+    SubgameInfoset& data = continuations[game.get_infoset(chooser)];
+    std::vector<float> probabilities(config.num_continuations), values(config.num_continuations);
+    subgame_search::calculate_strategy(data, probabilities);
+    float expected_value = 0.0f;
+    float prior_player_reach_prob = player_reach_prob[chooser];
+    for (int x=0; x<config.num_continuations; ++x) {
+        continuation[chooser] = x;
+        player_reach_prob[chooser] = prior_player_reach_prob * probabilities[x];
+        values[x] = leaf(game, player, chooser + 1, continuation, player_reach_prob, discount, evaluator, config);
+        expected_value += probabilities[x] * values[x];
+    }
+    player_reach_prob[chooser] = prior_player_reach_prob;
+    if (chooser == player)
+        subgame_search::update(data, probabilities, values, expected_value, subgame_search::get_opponent_reach(player, player_reach_prob), subgame_search::get_player_reach(player, player_reach_prob), discount);
+    return expected_value;
+}
+
+float SubgameSearch::cfr(Game& game, int player, int depth, std::vector<float>& player_reach_prob, Discount& discount, LeafEvaluator& evaluator, SearchConfig& config) {
+    if (game.is_finished()) {
+        return game.get_outcome_for_player(player);
+    } else if (game.is_chance_node()) {
+        // The cards to come were drawn for the deal of the traversal, so dealing only takes them from the deck.
+        Move action = game.sample_action();
+        game.execute(action);
+        float outcome = cfr(game, player, depth, player_reach_prob, discount, evaluator, config);
+        game.undo();
+        return outcome;
+    } else if (depth == config.max_depth) {
+        std::vector<int> continuation(game.get_num_players(), 0);
+        return leaf(game, player, 0, continuation, player_reach_prob, discount, evaluator, config);
+    }
+    int current_player = game.get_player_to_move();
+    std::vector<Move> actions;
+    actions.reserve(MAX_MOVES);
+    game.get_actions(actions);
+    assertm(actions.size() <= MAX_SUBGAME_ACTIONS, "The infoset has room for the actions.");
+    SubgameInfoset& data = infosets[game.get_infoset(current_player)];
+    std::vector<float> probabilities(actions.size()), values(actions.size());
+    subgame_search::calculate_strategy(data, probabilities);
+    float expected_value = 0.0f;
+    float prior_player_reach_prob = player_reach_prob[current_player];
+    for (int x=0; x<actions.size(); ++x) {
+        player_reach_prob[current_player] = prior_player_reach_prob * probabilities[x];
+        game.execute(actions[x]);
+        values[x] = cfr(game, player, depth + 1, player_reach_prob, discount, evaluator, config);
+        game.undo();
+        expected_value += probabilities[x] * values[x];
+    }
+    player_reach_prob[current_player] = prior_player_reach_prob;
+    if (player == current_player)
+        subgame_search::update(data, probabilities, values, expected_value, subgame_search::get_opponent_reach(player, player_reach_prob), subgame_search::get_player_reach(player, player_reach_prob), discount);
+    return expected_value;
+}
+
+void SubgameSearch::run_iterations(Game& game, const std::vector<Move>& history, std::vector<int>& deals, std::vector<float>& beliefs, std::atomic<int>& iterations, std::chrono::steady_clock::time_point deadline, robin_hood::unordered_map<uint64_t, robin_hood::unordered_map<Move, float>>& blueprint, SearchConfig& config, int node, uint32_t seed) {
+    // The first iteration is always run, so that there is a strategy when the budget is too small for any.
+    numa_topology::pin_thread_to_node(node);
+    // Every search thread samples with its own engine.
+    Rng rng(seed);
+    LeafEvaluator evaluator(blueprint, config.bias, config.num_rollouts, rng());
+    int num_players = game.get_num_players();
+    std::vector<float> player_reach_prob(num_players + 1);
+    int iteration = iterations.fetch_add(1, std::memory_order_relaxed);
+    while (iteration < config.max_iterations && (iteration == 0 || (std::chrono::steady_clock::now() < deadline && (config.token == nullptr || !config.token->is_cancelled())))) {
+        Discount discount = config.variant.get_discount(iteration);
+        for (int traverser=0; traverser<num_players; ++traverser) {
+            // Without enumerated beliefs, the deal is sampled uniformly and weighted with its belief instead.
+            float weight = 1.0f;
+            if (beliefs.empty()) {
+                subgame_search::sample_deal(game, rng);
+                weight = subgame_search::calculate_reach(game, history, blueprint);
+                // A deal that the history rules out would not change the regrets or the strategy.
+                if (weight == 0.0f)
+                    continue;
+            } else {
+                int deal = subgame_search::sample(rng, beliefs);
+                for (int x=0; x<num_players; ++x)
+                    game.set_private_state(x, deals[deal*num_players + x]);
+            }
+            // The cards to come are drawn again for every traversal, from the ones the deal leaves.
+            game.resample_chance(rng);
+            player_reach_prob.assign(num_players + 1, 1.0f);
+            player_reach_prob.back() = weight;
+            cfr(game, traverser, 0, player_reach_prob, discount, evaluator, config);
+        }
+        iteration = iterations.fetch_add(1, std::memory_order_relaxed);
+    }
+    // The iteration that was not run is given back.
+    iterations.fetch_sub(1, std::memory_order_relaxed);
+}
+
+SearchResult SubgameSearch::search(Game& game, const std::vector<Move>& history, robin_hood::unordered_map<uint64_t, robin_hood::unordered_map<Move, float>>& blueprint, SearchConfig config) {
+    /*
+        Searches for the strategy of the player to move, given the actions of the hand so far.
+        At least one iteration is run, and no new iteration is started after the time budget is
+        spent. The returned action is the most likely one in the average strategy.
+    */
+    assertm(!game.is_finished() && !game.is_chance_node(), "A player is to move.");
+    assertm(config.num_continuations >= 1 && config.num_continuations <= subgame_search::MAX_CONTINUATIONS, "The continuation strategies are the blueprint and the blueprint biased towards folding, calling and raising.");
+    assertm(game.get_max_actions() <= MAX_SUBGAME_ACTIONS, "The infosets have room for the actions.");
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + config.time_budget;
+    clear();
+    int num_players = game.get_num_players();
+    int player = game.get_player_to_move();
+    std::vector<int> private_states(num_players);
+    for (int x=0; x<num_players; ++x)
+        private_states[x] = game.get_private_state(x);
+
+    std::vector<int> deals;
+    std::vector<float> beliefs;
+    if (public_tree::count_deals(game) <= subgame_search::MAX_DEALS) {
+        deals = public_tree::enumerate_deals(game);
+        beliefs = subgame_search::calculate_beliefs(game, history, blueprint, deals);
+    }
+
+    // The first thread traverses the game itself, the others are given copies of it.
+    std::atomic<int> iterations{0};
+    int num_nodes = numa_topology::get_num_nodes();
+    std::vector<std::unique_ptr<Game>> games;
+    std::vector<std::thread> threads;
+    for (int thread=1; thread<config.num_threads; ++thread)
+        games.push_back(game.clone());
+    for (int thread=0; thread<config.num_threads; ++thread) {
+        Game& thread_game = thread == 0 ? game : *games[thread - 1];
+        threads.emplace_back(&SubgameSearch::run_iterations, this, std::ref(thread_game), std::cref(history), std::ref(deals), std::ref(beliefs), std::ref(iterations), deadline, std::ref(blueprint), std::ref(config), thread % num_nodes, rng());
+    }
+    for (std::thread& thread:threads)
+        thread.join();
+    int iteration = iterations.load();
+    for (int x=0; x<num_players; ++x)
+        game.set_private_state(x, private_states[x]);
+    // The cards to come were last drawn around the private states of a sampled deal.
+    game.resample_chance(rng);
+
+    std::vector<Move> actions;
+    actions.reserve(MAX_MOVES);
+    game.get_actions(actions);
+    SubgameInfoset& root = infosets[game.get_infoset(player)];
+    float sum = 0.0f;
+    for (int x=0; x<actions.size(); ++x)
+        sum += root.strategy[x].load(std::memory_order_relaxed);
+    SearchResult result{actions[0], {}, iteration};
+    for (int x=0; x<actions.size(); ++x) {
+        result.strategy[actions[x]] = (sum>0.0f) ? root.strategy[x].load(std::memory_order_relaxed)/sum : 1.0f/static_cast<float>(actions.size());
+        if (result.strategy[actions[x]] > result.strategy[result.action])
+            result.action = actions[x];
+    }
+    return result;
+}
@@ -0,0 +1,124 @@
+#ifndef SUBGAME_SEARCH_H
+#define SUBGAME_SEARCH_H
+
+#include <atomic>
+#include <vector>
+#include <chrono>
+#include <limits>
+#include <random>
+#include "game.h"
+#include "cfr_variants.h"
+#include "anytime.h"
+#include "sharded_table.h"
+#include "../lib/robin_hood.h"
+
+struct SearchConfig {
+    // The number of actions from the root of the subgame to its leaves.
+    int max_depth = 4;
+    std::chrono::milliseconds time_budget{5000};
+    int max_iterations = std::numeric_limits<int>::max();
+    // At a leaf, every player chooses between the blueprint and the blueprint biased towards
+    // folding, calling and raising, where the biased action is weighted by the bias factor. The
+    // value of a leaf is the average of a batch of rollouts, which is cached by each thread.
+    int num_continuations = 4;
+    float bias = 5.0f;
+    int num_rollouts = 16;
+    CFRVariant variant = cfr_variants::linear();
+    // The iterations are spread over the threads, which share the regrets of the subgame.
+    int num_threads = 1;
+    // Stops the search after the current iterations, like running out of time.
+    const CancellationToken* token = nullptr;
+};
+
+struct SearchResult {
+    Move action;
+    robin_hood::unordered_map<Move, float> strategy;
+    int iterations;
+};
+
+namespace subgame_search {
+
+    constexpr int MAX_CONTINUATIONS = 4;
+    // The most deals of private states that a search enumerates and weights with its beliefs. With
+    // more, like the hole cards of hold'em, every traversal samples a deal and weights it instead.
+    constexpr uint64_t MAX_DEALS = 1 << 20;
+
+}
+
+// The continuations are the actions of the infosets at the leaves.
+constexpr int MAX_SUBGAME_ACTIONS = MAX_MOVES > subgame_search::MAX_CONTINUATIONS ? MAX_MOVES : subgame_search::MAX_CONTINUATIONS;
+
+struct SubgameInfoset {
+    /*
+        The regrets and cumulative strategy of one infoset of the subgame, by action index, for
+        games with at most MAX_SUBGAME_ACTIONS actions at a node, which the search checks. The
+        search threads update every value with a compare-and-swap loop instead of a lock, so
+        concurrent updates of the same infoset are all kept.
+    */
+    std::atomic<float> regret[MAX_SUBGAME_ACTIONS];
+    std::atomic<float> strategy[MAX_SUBGAME_ACTIONS];
+
+    SubgameInfoset() {
+        for (int x=0; x<MAX_SUBGAME_ACTIONS; ++x) {
+            regret[x].store(0.0f, std::memory_order_relaxed);
+            strategy[x].store(0.0f, std::memory_order_relaxed);
+        }
+    }
+};
+
+namespace subgame_search {
+
+    float calculate_reach(Game&, const std::vector<Move>&, robin_hood::unordered_map<uint64_t, robin_hood::unordered_map<Move, float>>&);
+    std::vector<float> calculate_beliefs(Game&, const std::vector<Move>&, robin_hood::unordered_map<uint64_t, robin_hood::unordered_map<Move, float>>&, std::vector<int>&);
+    // Adds the regrets and strategy of one traversal of the infoset, and discounts them.
+    void update(SubgameInfoset&, std::vector<float>&, std::vector<float>&, float, float, float, Discount&);
+
+}
+
+class LeafEvaluator;
+
+class SubgameSearch {
+    /*
+        Depth-limited search from the current state of a game, as in Pluribus. The subgame
+        starts at the current public state, with every deal of private states weighted by how
+        likely the blueprint is to have played the actions so far with it. It is solved with
+        discounted CFR, sampling a deal per traversal, until the time budget is spent. When there
+        are at most MAX_DEALS deals, their beliefs are enumerated and the deals sampled from them;
+        otherwise a deal is sampled uniformly and its traversal weighted with its belief.
+
+        Chance nodes are sampled: every traversal draws the cards still to come again, from the
+        cards that its deal leaves, and deals them at the chance nodes of the subgame. The cards
+        that were dealt before the search are kept, and deals that share a card with them or with
+        each other are ruled out. When the search is done, the cards to come are drawn around the
+        private states of the game.
+
+        At the depth limit, each player in turn chooses one of the continuation strategies,
+        which are the blueprint and the blueprint biased towards an action, and the leaf is
+        valued by the LeafEvaluator of the thread, which rolls out the rest of the hand with the
+        chosen strategies and caches the values. Because the players pick their continuation in
+        the subgame, the search can not assume that the opponents keep playing one fixed
+        strategy beyond the leaves.
+
+        The iterations are run by one or more threads, that each traverse their own copy of the
+        game. They share the sharded regret tables, and sample with their own random engine,
+        which is seeded from the engine of the search. The threads are pinned to the NUMA nodes
+        round-robin, so that they do not have to look up their node when they access the tables.
+
+        A search owns its regret tables, so several searches can run in one process.
+    */
+    public:
+        ShardedTable<SubgameInfoset> infosets, continuations;
+
+        SubgameSearch(uint32_t seed = std::random_device()());
+        void clear();
+        SearchResult search(Game&, const std::vector<Move>&, robin_hood::unordered_map<uint64_t, robin_hood::unordered_map<Move, float>>&, SearchConfig);
+
+    private:
+        Rng rng;
+
+        float leaf(Game&, int, int, std::vector<int>&, std::vector<float>&, Discount&, LeafEvaluator&, SearchConfig&);
+        float cfr(Game&, int, int, std::vector<float>&, Discount&, LeafEvaluator&, SearchConfig&);
+        void run_iterations(Game&, const std::vector<Move>&, std::vector<int>&, std::vector<float>&, std::atomic<int>&, std::chrono::steady_clock::time_point, robin_hood::unordered_map<uint64_t, robin_hood::unordered_map<Move, float>>&, SearchConfig&, int, uint32_t);
+};
+
+#endif
@@ -0,0 +1,86 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <ostream>
+
+struct SolverStatistics {
+    int timestep;
+    // The totals of the solver since it was created or cleared.
+    int iterations;
+    uint64_t nodes_visited;
+    uint64_t terminal_evaluations;
+    uint64_t pruned_branches;
+    size_t num_infosets;
+    size_t memory;
+    // The rates over the interval since the previous report.
+    double seconds;
+    double iterations_per_second;
+    double nodes_per_second;
+};
+
+class Telemetry {
+    /*
+        Reports the statistics of a solver to a callback, at most once per interval. A solver
+        counts into its own plain counters, as it is used by one thread, and only checks the clock
+        between iterations when it has been given a telemetry. The counters are read when a report
+        is due, so an idle interval costs nothing but the check.
+    */
+    public:
+        typedef std::function<void(const SolverStatistics&)> Callback;
+
+        Telemetry(Callback callback, std::chrono::steady_clock::duration interval) : callback{callback}, interval{interval} {
+            start(0, 0);
+        }
+
+        void start(int iterations, uint64_t nodes_visited) {
+            // Called by the solver that is given the telemetry, so the first rates only cover its run.
+            previous_time = std::chrono::steady_clock::now();
+            next_report = previous_time + interval;
+            previous_iterations = iterations;
+            previous_nodes_visited = nodes_visited;
+        }
+
+        inline bool is_due() const {
+            return std::chrono::steady_clock::now() >= next_report;
+        }
+
+        void report(SolverStatistics statistics) {
+            // Fills in the rates since the previous report.
+            std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+            statistics.seconds = std::chrono::duration<double>(now - previous_time).count();
+            statistics.iterations_per_second = statistics.seconds > 0.0 ? static_cast<double>(statistics.iterations - previous_iterations) / statistics.seconds : 0.0;
+            statistics.nodes_per_second = statistics.seconds > 0.0 ? static_cast<double>(statistics.nodes_visited - previous_nodes_visited) / statistics.seconds : 0.0;
+            previous_time = now;
+            next_report = now + interval;
+            previous_iterations = statistics.iterations;
+            previous_nodes_visited = statistics.nodes_visited;
+            callback(statistics);
+        }
+
+        static Callback log(std::ostream& output) {
+            // One line per report, for following a long run.
+            return [&output](const SolverStatistics& statistics) {
+                output << "timestep " << statistics.timestep
+                       << " iterations/s " << statistics.iterations_per_second
+                       << " nodes/s " << statistics.nodes_per_second
+                       << " nodes " << statistics.nodes_visited
+                       << " terminals " << statistics.terminal_evaluations
+                       << " pruned " << statistics.pruned_branches
+                       << " infosets " << statistics.num_infosets
+                       << " bytes " << statistics.memory << std::endl;
+            };
+        }
+
+    private:
+        Callback callback;
+        std::chrono::steady_clock::duration interval;
+        std::chrono::steady_clock::time_point previous_time;
+        std::chrono::steady_clock::time_point next_report;
+        int previous_iterations;
+        uint64_t previous_nodes_visited;
+};
+
+#endif
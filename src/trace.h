@@ -0,0 +1,114 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <string>
+
+/*
+    Scoped trace events for profiling the phases of the traversals. A TRACE_SCOPE records the
+    time from where it is declared to the end of its block. The events are written as Chrome
+    trace events, which chrome://tracing and Perfetto show as a flame chart per thread.
+
+    Tracing is compiled in with -DTRACING. Without it, TRACE_SCOPE expands to nothing and
+    trace::write and trace::clear do nothing, so there is no cost in a normal build.
+*/
+
+#ifdef TRACING
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+struct TraceEvent {
+    const char* name;
+    int64_t start;
+    int64_t duration;
+};
+
+namespace trace {
+
+    struct ThreadBuffer {
+        int thread;
+        std::vector<TraceEvent> events;
+    };
+
+    // Every thread records into its own buffer, so the mutex is only taken by a thread's first event.
+    inline std::mutex mutex;
+    inline std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    inline const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+
+    inline int64_t now() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count();
+    }
+
+    inline ThreadBuffer& get_buffer() {
+        thread_local std::shared_ptr<ThreadBuffer> buffer;
+        if (!buffer) {
+            std::lock_guard<std::mutex> lock(mutex);
+            buffer = std::make_shared<ThreadBuffer>();
+            buffer->thread = buffers.size();
+            buffers.push_back(buffer);
+        }
+        return *buffer;
+    }
+
+    inline void clear() {
+        // Not safe while other threads are recording.
+        std::lock_guard<std::mutex> lock(mutex);
+        for (std::shared_ptr<ThreadBuffer>& buffer:buffers)
+            buffer->events.clear();
+    }
+
+    inline void write(const std::string& file_name) {
+        // Writes the events of all threads as complete events, with the times in microseconds.
+        std::lock_guard<std::mutex> lock(mutex);
+        std::ofstream ofs(file_name);
+        ofs << std::fixed << std::setprecision(3);
+        ofs << "{\"traceEvents\":[";
+        bool first = true;
+        for (std::shared_ptr<ThreadBuffer>& buffer:buffers) {
+            for (TraceEvent& event:buffer->events) {
+                ofs << (first ? "\n" : ",\n") << "{\"name\":\"" << event.name << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << buffer->thread
+                    << ",\"ts\":" << static_cast<double>(event.start) / 1000.0 << ",\"dur\":" << static_cast<double>(event.duration) / 1000.0 << "}";
+                first = false;
+            }
+        }
+        ofs << "\n],\"displayTimeUnit\":\"ns\"}\n";
+    }
+
+}
+
+class TraceScope {
+    public:
+        TraceScope(const char* name) : name{name}, start{trace::now()} {}
+
+        ~TraceScope() {
+            trace::get_buffer().events.push_back(TraceEvent{name, start, trace::now() - start});
+        }
+
+    private:
+        const char* name;
+        int64_t start;
+};
+
+#define TRACE_CONCATENATE_(a, b) a##b
+#define TRACE_CONCATENATE(a, b) TRACE_CONCATENATE_(a, b)
+#define TRACE_SCOPE(name) TraceScope TRACE_CONCATENATE(trace_scope_, __LINE__)(name)
+
+#else
+
+namespace trace {
+
+    inline void clear() {}
+    inline void write(const std::string&) {}
+
+}
+
+#define TRACE_SCOPE(name)
+
+#endif
+
+#endif
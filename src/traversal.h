@@ -0,0 +1,86 @@
+#ifndef TRAVERSAL_H
+#define TRAVERSAL_H
+
+#include <vector>
+#include <cstdint>
+#include "game.h"
+#include "tree.h"
+#include "quantized.h"
+
+/*
+    The frames of a traversal that walks the game with an explicit stack instead of recursion.
+    There is one frame per depth, and the frames keep their vectors between traversals, so a
+    traversal does not allocate once the deepest path has been seen. The depth of a traversal is
+    not limited by the stack of its thread.
+*/
+
+enum class FrameKind {
+    // A single action was sampled, and the value of the child is the value of the frame.
+    SAMPLED,
+    // The actions are visited one after the other.
+    EXPLORED
+};
+
+struct TraversalFrame {
+    Node* node;
+    FrameKind kind;
+    // The index of the action whose child is being traversed.
+    int action;
+    int player;
+    uint64_t infoset;
+    int private_state;
+    // The regrets and strategy of the infoset in a node or block, or nullptr when they are hashed.
+    float* regret;
+    float* strategy;
+    // The quantized record of the infoset, looked up once when the frame is entered.
+    QuantizedInfoset* record;
+    float expected_value;
+    float prior_reach_prob;
+    std::vector<Move> actions;
+    std::vector<float> probabilities;
+    std::vector<float> values;
+    std::vector<bool> explored;
+
+    TraversalFrame() {
+        actions.reserve(MAX_MOVES);
+        probabilities.reserve(MAX_MOVES);
+        values.reserve(MAX_MOVES);
+        explored.reserve(MAX_MOVES);
+    }
+};
+
+class TraversalStack {
+    public:
+        TraversalStack() : depth{0} {}
+
+        inline void start(Node* node) {
+            // A solver runs one traversal at a time, so a new traversal starts from an empty stack.
+            depth = 0;
+            push(node);
+        }
+
+        inline void push(Node* node) {
+            // Pushing can move the frames, so a reference to a frame is not used after a push.
+            if (depth == frames.size())
+                frames.emplace_back();
+            frames[depth++].node = node;
+        }
+
+        inline void pop() {
+            --depth;
+        }
+
+        inline TraversalFrame& top() {
+            return frames[depth - 1];
+        }
+
+        inline bool empty() const {
+            return depth == 0;
+        }
+
+    private:
+        std::vector<TraversalFrame> frames;
+        size_t depth;
+};
+
+#endif
@@ -3,57 +3,216 @@
 
 #include <type_traits>
 #include <vector>
+#include <memory>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
 #include "game.h"
+#include "../lib/robin_hood.h"
 
 typedef std::underlying_type<Cards>::type cards_type;
 typedef std::underlying_type<Move>::type move_type;
 
-struct Tree {
-    int num;
-    Tree* children[MAX_MOVES];
+// Where a solver keeps its regrets and strategies: hashed by infoset, or in a Tree that is walked alongside the game.
+// QUANTIZED hashes one compact record per infoset with integer regrets, and is only supported by mccfr.
+// BLOCK hashes one Block per public state, with the regrets of all private states next to each other, and is
+// only supported by lcfr.
+enum class RegretStorage {
+    HASH_MAP, TREE, QUANTIZED, BLOCK
+};
+
+// Children are referred to by their index in the tree. The root is never a child, so index 0 marks a missing child.
+constexpr uint32_t NO_CHILD = 0;
+
+struct Node {
+    std::atomic<uint32_t> children[MAX_MOVES];
     float infoset_regret[MAX_CARDS][MAX_MOVES];
     float infoset_strategy[MAX_CARDS][MAX_MOVES];
 
-    Tree() : children() {}
+    Node() {
+        reset();
+    }
 
-    int delete_tree() {
-        int num_deleted = delete_children(0);
-        delete this;
-        return num_deleted;
+    inline void reset() {
+        for (std::atomic<uint32_t>& child:children)
+            child.store(NO_CHILD, std::memory_order_relaxed);
+        std::memset(infoset_regret, 0, sizeof(infoset_regret));
+        std::memset(infoset_strategy, 0, sizeof(infoset_strategy));
     }
 
-    int delete_children(int depth){
-        int deleted_children = 0;
-        for (Tree* child:children) {
-            if (child != nullptr)
-                deleted_children += child->delete_children(depth+1);
-            delete child;
-            deleted_children++;
-        }
-        return deleted_children;
+    // The actions are referred to by their position in the list of legal actions.
+    inline float get_regret(Cards card, int action) {
+        return infoset_regret[static_cast<int>(card)][action];
     }
 
-    inline float get_regret(Cards card, Move move) {
-        return infoset_regret[static_cast<cards_type>(card)][static_cast<move_type>(move)];
+    inline void set_regret(Cards card, int action, float regret) {
+        infoset_regret[static_cast<int>(card)][action] = regret;
     }
 
-    inline void set_regret(Cards card, Move move, float regret) {
-        infoset_regret[static_cast<cards_type>(card)][static_cast<move_type>(move)] = regret;
+    inline float get_strategy(Cards card, int action) {
+        return infoset_strategy[static_cast<int>(card)][action];
+    }
+
+    inline void set_strategy(Cards card, int action, float strategy) {
+        infoset_strategy[static_cast<int>(card)][action] = strategy;
+    }
+};
+
+struct Block {
+    /*
+        The regrets and strategies of every private state of a public state, in one row of
+        num_actions values per private state. Unlike a tree node, a block is sized by the game
+        when it is first reached, so it is not limited by MAX_CARDS and MAX_MOVES.
+    */
+    int num_actions = 0;
+    std::vector<float> regret;
+    std::vector<float> strategy;
+
+    inline void resize(int num_private_states, int actions) {
+        num_actions = actions;
+        regret.assign(static_cast<size_t>(num_private_states) * actions, 0.0f);
+        strategy.assign(static_cast<size_t>(num_private_states) * actions, 0.0f);
     }
 
-    inline float get_strategy(Cards card, Move move) {
-        return infoset_strategy[static_cast<cards_type>(card)][static_cast<move_type>(move)];
+    inline int get_num_private_states() const {
+        return num_actions == 0 ? 0 : static_cast<int>(regret.size() / num_actions);
     }
 
-    inline void set_strategy(Cards card, Move move, float strategy) {
-        infoset_strategy[static_cast<cards_type>(card)][static_cast<move_type>(move)] = strategy;
+    inline float* get_regret(int private_state) {
+        return &regret[static_cast<size_t>(private_state) * num_actions];
     }
 
-    Tree* get_child(int move) {
-        if (children[move] == nullptr)
-            children[move] = new Tree();
-        return children[move];
+    inline float* get_strategy(int private_state) {
+        return &strategy[static_cast<size_t>(private_state) * num_actions];
     }
 };
 
+// The blocks of BLOCK storage, keyed by the public state. The rows stay in place when the table grows.
+typedef robin_hood::unordered_node_map<uint64_t, Block> BlockTable;
+
+class Tree {
+    /*
+        The nodes are allocated from chunks of contiguous memory and are never freed one by one.
+        Clearing the tree only resets the number of used nodes, so the chunks are reused by the
+        next tree that is built.
+
+        get_child is lock-free and can be called by several threads at once. A missing child is
+        allocated and published with a compare-and-swap on the child slot; the thread that loses
+        the race returns its node to a free list and uses the winner's node. Clearing the tree is
+        not thread-safe.
+    */
+    public:
+        static constexpr int CHUNK_BITS = 12;
+        static constexpr uint32_t CHUNK_SIZE = 1U << CHUNK_BITS;
+        static constexpr uint32_t CHUNK_MASK = CHUNK_SIZE - 1;
+        static constexpr uint32_t MAX_CHUNKS = 4096;
+
+        Tree() : chunks(new std::atomic<Node*>[MAX_CHUNKS]), num_nodes(0), num_free(0), free_list(0) {
+            for (uint32_t chunk=0; chunk<MAX_CHUNKS; ++chunk)
+                chunks[chunk].store(nullptr, std::memory_order_relaxed);
+            allocate();
+        }
+
+        ~Tree() {
+            for (uint32_t chunk=0; chunk<MAX_CHUNKS; ++chunk)
+                delete[] chunks[chunk].load(std::memory_order_relaxed);
+        }
+
+        Tree(const Tree&) = delete;
+        Tree& operator=(const Tree&) = delete;
+
+        inline Node* get_node(uint32_t index) {
+            return &chunks[index >> CHUNK_BITS].load(std::memory_order_acquire)[index & CHUNK_MASK];
+        }
+
+        inline Node* get_root() {
+            return get_node(0);
+        }
+
+        inline Node* get_child(Node* node, int action) {
+            assertm(action < MAX_MOVES, "The node has room for the action.");
+            uint32_t child = node->children[action].load(std::memory_order_acquire);
+            if (child == NO_CHILD) {
+                // Allocating can not move the existing nodes, so the parent pointer stays valid.
+                uint32_t new_child = allocate();
+                if (node->children[action].compare_exchange_strong(child, new_child, std::memory_order_acq_rel, std::memory_order_acquire))
+                    child = new_child;
+                else
+                    release(new_child);
+            }
+            return get_node(child);
+        }
+
+        inline uint32_t size() {
+            return num_nodes.load(std::memory_order_relaxed) - num_free.load(std::memory_order_relaxed);
+        }
+
+        template <typename Function>
+        void for_each_node(Function function) {
+            // Nodes on the free list are visited as well; they are never handed out with data in them.
+            for (uint32_t index=0; index<num_nodes.load(std::memory_order_relaxed); ++index)
+                function(*get_node(index));
+        }
+
+        void clear() {
+            num_nodes.store(0, std::memory_order_relaxed);
+            num_free.store(0, std::memory_order_relaxed);
+            free_list.store(0, std::memory_order_relaxed);
+            allocate();
+        }
+
+        void resize(uint32_t size) {
+            // Used when restoring a tree; the nodes are zeroed and filled in by the caller.
+            clear();
+            while (num_nodes.load(std::memory_order_relaxed) < size)
+                allocate();
+        }
+
+    private:
+        std::unique_ptr<std::atomic<Node*>[]> chunks;
+        std::atomic<uint32_t> num_nodes;
+        std::atomic<uint32_t> num_free;
+        // The upper half is a tag that is bumped on every update to avoid ABA, the lower half is
+        // the index of the first free node. The next free node is stored in its first child slot.
+        std::atomic<uint64_t> free_list;
+
+        uint32_t allocate() {
+            uint32_t index = pop_free();
+            if (index == NO_CHILD) {
+                index = num_nodes.fetch_add(1, std::memory_order_relaxed);
+                assertm(index >> CHUNK_BITS < MAX_CHUNKS, "Tree is not full.");
+                std::atomic<Node*>& chunk = chunks[index >> CHUNK_BITS];
+                if (chunk.load(std::memory_order_acquire) == nullptr) {
+                    Node* expected = nullptr;
+                    Node* new_chunk = new Node[CHUNK_SIZE];
+                    if (!chunk.compare_exchange_strong(expected, new_chunk, std::memory_order_acq_rel, std::memory_order_acquire))
+                        delete[] new_chunk;
+                }
+            }
+            // Chunks are reused after a clear, so the node is reset when it is handed out.
+            get_node(index)->reset();
+            return index;
+        }
+
+        void release(uint32_t index) {
+            num_free.fetch_add(1, std::memory_order_relaxed);
+            uint64_t head = free_list.load(std::memory_order_acquire);
+            do {
+                get_node(index)->children[0].store(static_cast<uint32_t>(head), std::memory_order_relaxed);
+            } while (!free_list.compare_exchange_weak(head, (((head >> 32) + 1) << 32) | index, std::memory_order_acq_rel, std::memory_order_acquire));
+        }
+
+        uint32_t pop_free() {
+            uint64_t head = free_list.load(std::memory_order_acquire);
+            while (static_cast<uint32_t>(head) != NO_CHILD) {
+                uint32_t next = get_node(static_cast<uint32_t>(head))->children[0].load(std::memory_order_relaxed);
+                if (free_list.compare_exchange_weak(head, (((head >> 32) + 1) << 32) | next, std::memory_order_acq_rel, std::memory_order_acquire)) {
+                    num_free.fetch_sub(1, std::memory_order_relaxed);
+                    return static_cast<uint32_t>(head);
+                }
+            }
+            return NO_CHILD;
+        }
+};
+
 #endif
@@ -0,0 +1,48 @@
+#ifndef UNDO_LOG_H
+#define UNDO_LOG_H
+
+#include <vector>
+
+template <typename T>
+class UndoLog {
+    /*
+        The values that an action overwrites, pushed by execute and popped by undo, so that undoing
+        an action is as cheap as executing it. The entries should be small plain structs. The
+        capacity is kept when the log is cleared for the next hand.
+    */
+    public:
+        UndoLog(size_t capacity = 64) {
+            entries.reserve(capacity);
+        }
+
+        inline void push(const T& entry) {
+            entries.push_back(entry);
+        }
+
+        inline T pop() {
+            T entry = entries.back();
+            entries.pop_back();
+            return entry;
+        }
+
+        inline T& back() {
+            return entries.back();
+        }
+
+        inline void clear() {
+            entries.clear();
+        }
+
+        inline size_t size() {
+            return entries.size();
+        }
+
+        inline bool empty() {
+            return entries.empty();
+        }
+
+    private:
+        std::vector<T> entries;
+};
+
+#endif
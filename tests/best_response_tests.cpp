@@ -0,0 +1,76 @@
+#include "gtest/gtest.h"
+#include "../src/best_response.h"
+#include "../src/kuhn_poker.h"
+#include "../src/public_cfr.h"
+#include "../src/holdem.h"
+
+robin_hood::unordered_map<uint64_t, robin_hood::unordered_map<Move, float>> two_player_kuhn_poker_equilibrium() {
+    // The equilibrium with alpha = 0 from https://en.wikipedia.org/wiki/Kuhn_poker#Optimal_strategy
+    robin_hood::unordered_map<uint64_t, robin_hood::unordered_map<Move, float>> strategy;
+    for (Cards card:{Cards::A, Cards::K, Cards::Q}) {
+        strategy[to_infoset("", card)] = {{Move::C, 1.0f}, {Move::R, 0.0f}};
+    }
+    strategy[to_infoset("C", Cards::A)] = {{Move::C, 0.0f}, {Move::R, 1.0f}};
+    strategy[to_infoset("C", Cards::K)] = {{Move::C, 1.0f}, {Move::R, 0.0f}};
+    strategy[to_infoset("C", Cards::Q)] = {{Move::C, 2.0f/3.0f}, {Move::R, 1.0f/3.0f}};
+    strategy[to_infoset("R", Cards::A)] = {{Move::C, 1.0f}, {Move::F, 0.0f}};
+    strategy[to_infoset("R", Cards::K)] = {{Move::C, 1.0f/3.0f}, {Move::F, 2.0f/3.0f}};
+    strategy[to_infoset("R", Cards::Q)] = {{Move::C, 0.0f}, {Move::F, 1.0f}};
+    strategy[to_infoset("CR", Cards::A)] = {{Move::C, 1.0f}, {Move::F, 0.0f}};
+    strategy[to_infoset("CR", Cards::K)] = {{Move::C, 1.0f/3.0f}, {Move::F, 2.0f/3.0f}};
+    strategy[to_infoset("CR", Cards::Q)] = {{Move::C, 0.0f}, {Move::F, 1.0f}};
+    return strategy;
+}
+
+TEST(BestResponse, TwoPlayerKuhnPokerEquilibrium) {
+    KuhnPoker kuhn_poker(2);
+    auto strategy = two_player_kuhn_poker_equilibrium();
+
+    Exploitability exploitability = best_response::calculate_exploitability(kuhn_poker, strategy);
+
+    ASSERT_NEAR(exploitability.exploitability, 0.0f, 1.0e-5f);
+    ASSERT_NEAR(exploitability.strategy_values[0], -1.0f/18.0f, 1.0e-5f);
+    ASSERT_NEAR(exploitability.strategy_values[1], 1.0f/18.0f, 1.0e-5f);
+    ASSERT_NEAR(exploitability.best_response_values[0], -1.0f/18.0f, 1.0e-5f);
+}
+
+TEST(BestResponse, TwoPlayerKuhnPokerUniformStrategy) {
+    // Infosets that are missing from the strategy are played uniformly at random.
+    KuhnPoker kuhn_poker(2);
+    robin_hood::unordered_map<uint64_t, robin_hood::unordered_map<Move, float>> strategy;
+
+    Exploitability exploitability = best_response::calculate_exploitability(kuhn_poker, strategy);
+
+    ASSERT_NEAR(exploitability.exploitability, 11.0f/12.0f, 1.0e-5f);
+    ASSERT_NEAR(exploitability.strategy_values[0] + exploitability.strategy_values[1], 0.0f, 1.0e-5f);
+}
+
+TEST(BestResponse, ExploitabilityDecreases) {
+    KuhnPoker kuhn_poker(3);
+    PublicCFR solver;
+
+    solver.search(10, kuhn_poker);
+    auto early_strategy = solver.calculate_cumulative_strategy(kuhn_poker);
+    solver.search(1000, kuhn_poker);
+    auto strategy = solver.calculate_cumulative_strategy(kuhn_poker);
+
+    float early_exploitability = best_response::calculate_exploitability(kuhn_poker, early_strategy).exploitability;
+    float exploitability = best_response::calculate_exploitability(kuhn_poker, strategy).exploitability;
+    ASSERT_LT(exploitability, early_exploitability);
+    ASSERT_LT(exploitability, 0.01f);
+}
+
+TEST(BestResponse, ChanceNodes) {
+    // After the small blind calls and the big blind checks, the flop is dealt.
+    Holdem holdem({300, 300}, 50, 100);
+    Move call = Move::C;
+    holdem.execute(call);
+    holdem.execute(call);
+    robin_hood::unordered_map<uint64_t, robin_hood::unordered_map<Move, float>> strategy;
+    std::vector<int> deals;
+    std::vector<Range> reach(holdem.get_num_players());
+    Range best_response_values, strategy_values;
+
+    ASSERT_TRUE(holdem.is_chance_node());
+    ASSERT_THROW(best_response::best_response(holdem, 0, strategy, deals, reach, best_response_values, strategy_values), std::runtime_error);
+}
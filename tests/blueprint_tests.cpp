@@ -0,0 +1,77 @@
+#include "gtest/gtest.h"
+#include "../src/blueprint.h"
+#include "../src/best_response.h"
+#include "../src/kuhn_poker.h"
+#include "../src/public_cfr.h"
+
+struct BlueprintTest: public testing::Test {
+    std::string file_name = testing::TempDir() + "blueprint";
+    KuhnPoker kuhn_poker{2};
+    robin_hood::unordered_map<uint64_t, robin_hood::unordered_map<Move, float>> strategy;
+
+    BlueprintTest() {
+        PublicCFR solver;
+        solver.search(1000, kuhn_poker);
+        strategy = solver.calculate_cumulative_strategy(kuhn_poker);
+    };
+    ~BlueprintTest() {
+        std::remove(file_name.c_str());
+    };
+};
+
+TEST_F(BlueprintTest, Header) {
+    blueprint::write(file_name, kuhn_poker, "kuhn_poker", "none", strategy, 16);
+    Blueprint blueprint(file_name);
+
+    ASSERT_EQ(blueprint.size(), strategy.size());
+    ASSERT_EQ(blueprint.get_header().probability_bits, 16);
+    ASSERT_EQ(blueprint.get_header().num_players, 2);
+    ASSERT_EQ(blueprint.get_header().num_private_states, 3);
+    ASSERT_EQ(std::string(blueprint.get_header().game), "kuhn_poker");
+    ASSERT_EQ(std::string(blueprint.get_header().abstraction), "none");
+}
+
+TEST_F(BlueprintTest, QuantizedProbabilities) {
+    for (int probability_bits:{8, 16}) {
+        blueprint::write(file_name, kuhn_poker, "kuhn_poker", "none", strategy, probability_bits);
+        Blueprint blueprint(file_name);
+        float error_treshold = 0.5f / static_cast<float>((1 << probability_bits) - 1) + 1.0e-6f;
+
+        for (auto const& [infoset, infoset_strategy]:strategy) {
+            ASSERT_TRUE(blueprint.contains(infoset));
+            ASSERT_EQ(blueprint.get_strategy(infoset).size(), infoset_strategy.size());
+            for (auto const& [action, probability]:infoset_strategy)
+                ASSERT_NEAR(blueprint.get_probability(infoset, action), probability, error_treshold);
+        }
+    }
+}
+
+TEST_F(BlueprintTest, MissingInfoset) {
+    blueprint::write(file_name, kuhn_poker, "kuhn_poker", "none", strategy, 8);
+    Blueprint blueprint(file_name);
+    uint64_t infoset = to_infoset("RR", Cards::A);
+
+    ASSERT_FALSE(blueprint.contains(infoset));
+    ASSERT_TRUE(blueprint.get_strategy(infoset).empty());
+    ASSERT_THROW(blueprint.get_probability(infoset, Move::C), std::runtime_error);
+}
+
+TEST_F(BlueprintTest, Exploitability) {
+    blueprint::write(file_name, kuhn_poker, "kuhn_poker", "none", strategy, 8);
+    Blueprint blueprint(file_name);
+    auto blueprint_strategy = blueprint.get_strategy();
+
+    float exploitability = best_response::calculate_exploitability(kuhn_poker, strategy).exploitability;
+    float blueprint_exploitability = best_response::calculate_exploitability(kuhn_poker, blueprint_strategy).exploitability;
+
+    ASSERT_NEAR(blueprint_exploitability, exploitability, 0.01f);
+}
+
+TEST(Blueprint, InvalidFile) {
+    std::string file_name = testing::TempDir() + "not_a_blueprint";
+    std::ofstream(file_name) << "not a blueprint";
+
+    ASSERT_THROW(Blueprint blueprint(file_name), std::runtime_error);
+    ASSERT_THROW(Blueprint blueprint(file_name + "_missing"), std::runtime_error);
+    std::remove(file_name.c_str());
+}
@@ -204,3 +204,252 @@ TEST(CalculateHandStrength, HandFrequency) {
         ASSERT_EQ(hand_frequency[x], correct_hand_frequency[x]);
 }
 
+
+void check_down(Holdem& holdem) {
+    // Calls and checks until the hand is finished, dealing the streets in between.
+    while (!holdem.is_finished()) {
+        Move action = holdem.is_chance_node() ? holdem.sample_action() : Move::C;
+        holdem.execute(action);
+    }
+}
+
+TEST(Holdem, Blinds) {
+    Holdem holdem(2);
+    std::vector<Move> actions;
+
+    holdem.get_actions(actions);
+
+    ASSERT_EQ(holdem.get_pot(), 150);
+    ASSERT_EQ(holdem.get_player_to_move(), 0);
+    ASSERT_EQ(actions, std::vector<Move>({Move::F, Move::C, Move::R}));
+    ASSERT_EQ(holdem.get_raise_to(0), 300);
+    ASSERT_EQ(__builtin_popcountll(holdem.get_hole_cards(0) | holdem.get_hole_cards(1)), 4);
+}
+
+TEST(Holdem, Fold) {
+    Holdem holdem(2);
+    Move action = Move::F;
+
+    holdem.execute(action);
+
+    ASSERT_TRUE(holdem.is_finished());
+    ASSERT_EQ(holdem.get_outcome_for_player(0), -50.0f);
+    ASSERT_EQ(holdem.get_outcome_for_player(1), 50.0f);
+}
+
+TEST(Holdem, Showdown) {
+    Holdem holdem(2);
+    holdem.reset_game({hand_test::hand_from_string("ca"), hand_test::hand_from_string("ck"), hand_test::hand_from_string("c2"), hand_test::hand_from_string("d7"),
+                       hand_test::hand_from_string("h3"), hand_test::hand_from_string("s8"), hand_test::hand_from_string("d9"), hand_test::hand_from_string("hj"), hand_test::hand_from_string("s4")});
+
+    check_down(holdem);
+
+    ASSERT_EQ(holdem.betting_round(), 3);
+    ASSERT_EQ(holdem.get_board(), hand_test::hand_from_string("h3 s8 d9 hj s4"));
+    ASSERT_EQ(holdem.get_outcome_for_player(0), 100.0f);
+    ASSERT_EQ(holdem.get_outcome_for_player(1), -100.0f);
+}
+
+TEST(Holdem, SidePot) {
+    Holdem holdem({30, 100, 100}, 5, 10);
+    holdem.reset_game({hand_test::hand_from_string("ca"), hand_test::hand_from_string("da"), hand_test::hand_from_string("ck"), hand_test::hand_from_string("dk"), hand_test::hand_from_string("c2"), hand_test::hand_from_string("d7"),
+                       hand_test::hand_from_string("h3"), hand_test::hand_from_string("s8"), hand_test::hand_from_string("d9"), hand_test::hand_from_string("hj"), hand_test::hand_from_string("s4")});
+    Move raise = Move::R;
+    holdem.execute(raise);
+    std::vector<Move> actions;
+    holdem.get_actions(actions);
+
+    check_down(holdem);
+
+    ASSERT_EQ(actions, std::vector<Move>({Move::F, Move::C}));
+    ASSERT_EQ(holdem.get_pot(), 100);
+    ASSERT_EQ(holdem.get_outcome_for_player(0), 60.0f);
+    ASSERT_EQ(holdem.get_outcome_for_player(1), -25.0f);
+    ASSERT_EQ(holdem.get_outcome_for_player(2), -35.0f);
+}
+
+TEST(Holdem, IncompleteAllIn) {
+    // The pot-sized raise of the short stack is capped at its stack of 400, a raise of 100 where
+    // at least 200 is a full raise, so the first player can call or fold but not raise again.
+    Holdem holdem({10000, 400}, 50, 100);
+    Move raise = Move::R;
+    holdem.execute(raise);
+    holdem.execute(raise);
+    std::vector<Move> actions;
+    holdem.get_actions(actions);
+
+    ASSERT_EQ(holdem.get_contribution(1), 400);
+    ASSERT_EQ(actions, std::vector<Move>({Move::F, Move::C}));
+    holdem.undo();
+    actions.clear();
+    holdem.get_actions(actions);
+    ASSERT_EQ(actions, std::vector<Move>({Move::F, Move::C, Move::R}));
+
+    // A full raise reopens the betting.
+    Holdem deep_holdem({10000, 10000}, 50, 100);
+    deep_holdem.execute(raise);
+    deep_holdem.execute(raise);
+    actions.clear();
+    deep_holdem.get_actions(actions);
+    ASSERT_EQ(actions, std::vector<Move>({Move::F, Move::C, Move::R}));
+}
+
+TEST(Holdem, Infoset) {
+    Holdem holdem(3);
+    std::vector<unsigned long long> cards;
+    for (std::string card:{"ca", "da", "ck", "dk", "c2", "d7"})
+        cards.push_back(hand_test::hand_from_string(card));
+    holdem.reset_game(cards);
+    Move call = Move::C;
+    holdem.execute(call);
+    uint64_t infoset = holdem.get_infoset(0);
+
+    holdem.reset_game(cards);
+    ASSERT_NE(holdem.get_infoset(0), infoset);
+    holdem.execute(call);
+    ASSERT_EQ(holdem.get_infoset(0), infoset);
+    ASSERT_NE(holdem.get_infoset(1), infoset);
+    std::swap(cards[0], cards[2]);
+    holdem.reset_game(cards);
+    holdem.execute(call);
+    ASSERT_NE(holdem.get_infoset(0), infoset);
+}
+
+TEST(Holdem, PublicAndPrivateState) {
+    Holdem holdem(3);
+    std::vector<unsigned long long> cards;
+    for (std::string card:{"ca", "da", "ck", "dk", "c2", "d7"})
+        cards.push_back(hand_test::hand_from_string(card));
+    holdem.reset_game(cards);
+    Move call = Move::C;
+    holdem.execute(call);
+    uint64_t public_state = holdem.get_public_state();
+
+    std::swap(cards[0], cards[2]);
+    holdem.reset_game(cards);
+    holdem.execute(call);
+    ASSERT_EQ(holdem.get_public_state(), public_state);
+    for (int private_state=0; private_state<Holdem::NUM_HOLE_CARD_COMBINATIONS; ++private_state) {
+        holdem.set_private_state(1, private_state);
+        ASSERT_EQ(holdem.get_private_state(1), private_state);
+    }
+}
+
+TEST(Holdem, ValidDeal) {
+    // The private states are set without the deck, so they can share cards with each other or the board.
+    Holdem holdem(2);
+    std::vector<unsigned long long> cards;
+    for (std::string card:{"ca", "da", "ck", "dk", "c2", "d7", "h9"})
+        cards.push_back(hand_test::hand_from_string(card));
+    holdem.reset_game(cards);
+    Move call = Move::C, deal = Move::NONE;
+    holdem.execute(call);
+    holdem.execute(call);
+    holdem.execute(deal);
+    ASSERT_EQ(holdem.get_board(), cards[4] | cards[5] | cards[6]);
+    ASSERT_TRUE(holdem.is_valid_deal());
+
+    for (int private_state=0; private_state<Holdem::NUM_HOLE_CARD_COMBINATIONS; ++private_state) {
+        holdem.set_private_state(1, private_state);
+        bool overlaps = (holdem.get_hole_cards(1) & (holdem.get_hole_cards(0) | holdem.get_board())) != 0;
+        ASSERT_EQ(holdem.is_valid_deal(), !overlaps);
+    }
+}
+
+TEST(Holdem, UndoAndZeroSum) {
+    random_engine.seed(42);
+    for (int players=2; players<=6; ++players) {
+        Holdem holdem(players);
+        for (int hand=0; hand<1000; ++hand) {
+            holdem.reset_game();
+            std::vector<uint64_t> infosets;
+            std::vector<int> pots;
+            while (!holdem.is_finished()) {
+                infosets.push_back(holdem.get_current_infoset());
+                pots.push_back(holdem.get_pot());
+                Move action = holdem.get_random_action();
+                holdem.execute(action);
+            }
+            float sum = 0.0f;
+            for (int player=0; player<players; ++player)
+                sum += holdem.get_outcome_for_player(player);
+            ASSERT_NEAR(sum, 0.0f, 1.0e-3f);
+
+            for (int x=infosets.size()-1; x>=0; --x) {
+                holdem.undo();
+                ASSERT_EQ(holdem.get_current_infoset(), infosets[x]);
+                ASSERT_EQ(holdem.get_pot(), pots[x]);
+            }
+            ASSERT_EQ(holdem.get_board(), 0ULL);
+        }
+    }
+}
+
+ActionAbstraction create_test_abstraction() {
+    // Half pot, pot and all-in for the first raise of a round; only all-in after that.
+    ActionAbstraction abstraction;
+    for (int round=0; round<Holdem::NUM_ROUNDS; ++round) {
+        abstraction.set_raise_sizes(round, 0, {0.5f, 1.0f, ActionAbstraction::ALL_IN});
+        abstraction.set_raise_sizes(round, 1, {ActionAbstraction::ALL_IN});
+    }
+    return abstraction;
+}
+
+TEST(ActionAbstraction, RaiseSizes) {
+    Holdem holdem({10000, 10000}, 50, 100, create_test_abstraction());
+    std::vector<Move> actions;
+    holdem.get_actions(actions);
+
+    ASSERT_EQ(actions, std::vector<Move>({Move::F, Move::C, raise_move(0), raise_move(1), raise_move(2)}));
+    ASSERT_EQ(holdem.get_raise_to(0), 200);
+    ASSERT_EQ(holdem.get_raise_to(1), 300);
+    ASSERT_EQ(holdem.get_raise_to(2), 10000);
+
+    Move action = raise_move(1);
+    holdem.execute(action);
+    actions.clear();
+    holdem.get_actions(actions);
+
+    ASSERT_EQ(holdem.get_pot(), 400);
+    ASSERT_EQ(actions, std::vector<Move>({Move::F, Move::C, raise_move(0)}));
+    ASSERT_EQ(holdem.get_raise_to(0), 10000);
+    holdem.undo();
+    ASSERT_EQ(holdem.get_pot(), 150);
+}
+
+TEST(ActionAbstraction, SizesAboveTheStack) {
+    // Raises that would be larger than the stack are all-in, and only offered once.
+    Holdem holdem({250, 250}, 50, 100, create_test_abstraction());
+    std::vector<Move> actions;
+    holdem.get_actions(actions);
+
+    ASSERT_EQ(actions, std::vector<Move>({Move::F, Move::C, raise_move(0), raise_move(1)}));
+    ASSERT_EQ(holdem.get_raise_to(1), 250);
+}
+
+TEST(ActionAbstraction, PseudoHarmonicMapping) {
+    ASSERT_FLOAT_EQ(ActionAbstraction::get_lower_probability(0.5f, 1.0f, 0.5f), 1.0f);
+    ASSERT_FLOAT_EQ(ActionAbstraction::get_lower_probability(0.5f, 1.0f, 1.0f), 0.0f);
+    ASSERT_FLOAT_EQ(ActionAbstraction::get_lower_probability(0.5f, 1.0f, 0.75f), 0.25f * 1.5f / (0.5f * 1.75f));
+}
+
+TEST(ActionAbstraction, TranslateRaise) {
+    random_engine.seed(42);
+    Holdem holdem({10000, 10000}, 50, 100, create_test_abstraction());
+
+    ASSERT_EQ(holdem.translate_raise(200), raise_move(0));
+    ASSERT_EQ(holdem.translate_raise(150), raise_move(0));
+    ASSERT_EQ(holdem.translate_raise(300), raise_move(1));
+    ASSERT_EQ(holdem.translate_raise(10000), raise_move(2));
+
+    // A raise to 250 is 3/4 of the pot after the call, between the half pot and the pot raise.
+    int num_lower = 0;
+    for (int x=0; x<10000; ++x)
+        num_lower += holdem.translate_raise(250) == raise_move(0);
+    ASSERT_NEAR(num_lower / 10000.0f, ActionAbstraction::get_lower_probability(0.5f, 1.0f, 0.75f), 0.02f);
+
+    // With an engine of its own, the translation is the same for the same seed.
+    Rng rng(7), same_rng(7);
+    for (int x=0; x<100; ++x)
+        ASSERT_EQ(holdem.translate_raise(250, rng), holdem.translate_raise(250, same_rng));
+}
@@ -0,0 +1,90 @@
+#include "gtest/gtest.h"
+#include "../src/kuhn_poker.h"
+#include "../src/infoset_observer.h"
+
+
+void play_out(Game& game) {
+    if (game.is_finished())
+        return;
+    std::vector<Move> actions;
+    game.get_actions(actions);
+    for (Move action:actions) {
+        uint64_t infoset = game.get_current_infoset();
+        game.execute(action);
+        play_out(game);
+        game.undo();
+        ASSERT_EQ(game.get_current_infoset(), infoset);
+    }
+}
+
+TEST(KuhnPokerTest, UndoRestoresState) {
+    random_engine.seed(42);
+    KuhnPoker kuhn_poker(3);
+    Game& game = kuhn_poker;
+
+    std::vector<Move> betting = {Move::C, Move::R, Move::C, Move::F};
+    for (Move& action:betting)
+        game.execute(action);
+    ASSERT_TRUE(game.is_finished());
+    std::vector<float> outcomes;
+    for (int player=0; player<game.get_num_players(); ++player)
+        outcomes.push_back(game.get_outcome_for_player(player));
+
+    game.undo();
+    game.undo();
+    ASSERT_TRUE(game.is_player_in_hand(2));
+    ASSERT_EQ(game.get_player_to_move(), 2);
+    for (int x=2; x<betting.size(); ++x)
+        game.execute(betting[x]);
+    for (int player=0; player<game.get_num_players(); ++player)
+        ASSERT_EQ(game.get_outcome_for_player(player), outcomes[player]);
+}
+
+TEST(KuhnPokerTest, InfosetRecorder) {
+    random_engine.seed(42);
+    KuhnPoker kuhn_poker(2);
+    Game& game = kuhn_poker;
+    InfosetRecorder recorder(game.get_num_players());
+
+    game.set_infoset_observer(&recorder);
+    for (int card_0=0; card_0<game.get_num_private_states(); ++card_0) {
+        for (int card_1=0; card_1<game.get_num_private_states(); ++card_1) {
+            if (card_0 == card_1)
+                continue;
+            game.reset_game();
+            game.set_private_state(0, card_0);
+            game.set_private_state(1, card_1);
+            play_out(game);
+        }
+    }
+
+    // Each player acts after two different histories, with each of the three cards.
+    ASSERT_EQ(recorder.get_infosets(0).size(), 6);
+    ASSERT_EQ(recorder.get_infosets(1).size(), 6);
+    for (uint64_t infoset:recorder.get_infosets(1))
+        ASSERT_EQ(recorder.get_actions(infoset).size(), 2);
+
+    // Games without an observer do not record anything.
+    game.set_infoset_observer(nullptr);
+    game.reset_game();
+    play_out(game);
+    ASSERT_EQ(recorder.get_infosets(0).size(), 6);
+}
+
+TEST(KuhnPokerTest, Clone) {
+    random_engine.seed(42);
+    KuhnPoker kuhn_poker(2);
+    Game& game = kuhn_poker;
+    Move bet = Move::R;
+    game.execute(bet);
+
+    std::unique_ptr<Game> copy = game.clone();
+    Move fold = Move::F;
+    copy->execute(fold);
+
+    ASSERT_TRUE(copy->is_finished());
+    ASSERT_FALSE(game.is_finished());
+    ASSERT_EQ(copy->get_outcome_for_player(0), 1.0f);
+    copy->undo();
+    ASSERT_EQ(copy->get_current_infoset(), game.get_current_infoset());
+}
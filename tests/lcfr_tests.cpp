@@ -1,13 +1,15 @@
 #include "optimal_strategies_tests.h"
-#include "../src/lcfr.cpp"
+#include "../src/lcfr.h"
+#include "../src/kuhn_poker.h"
+#include "../src/holdem.h"
+#include "../src/best_response.h"
+#include <thread>
 
 struct LCFRTest: public testing::Test {
-    LCFRTest() {
-        srand(42);
-    };
-    ~LCFRTest() {
-        lcfr::regret.clear();
-        lcfr::cumulative_strategy.clear();
+    LCFR solver;
+
+    LCFRTest() : solver{RegretStorage::HASH_MAP, 42} {
+        random_engine.seed(42);
     };
 };
 
@@ -17,21 +19,185 @@ TEST_F(LCFRTest, TwoPlayerKuhnPokerOptimalStrategy) {
     int timesteps = 200000;
     float error_treshold = 0.03f;
 
-    lcfr::search(timesteps, kuhn_poker);
-    auto strategy = lcfr::calculate_cumulative_strategy();
+    solver.search(timesteps, kuhn_poker);
+    auto strategy = solver.calculate_cumulative_strategy();
 
     ASSERT_NO_THROW(test_two_player_kuhn_poker(error_treshold, strategy));
 }
 
 TEST_F(LCFRTest, ThreePlayerKuhnPokerOptimalStrategy) {
-    // The optimal strategy for three player Kuhn poker is described here: https://poker.cs.ualberta.ca/publications/AAMAS13-3pkuhn.pdf
-    // The variables are using the notation from the paper.
+    // Three player Kuhn poker has a family of equilibria, and which member the sampled deals
+    // lead to depends on the seed, so the strategy is checked by its exploitability instead of
+    // against the parameters of one equilibrium.
     KuhnPoker kuhn_poker(3);
-    int timesteps = 10000000;
+    int timesteps = 3000000;
+    float max_exploitability = 0.01f;
+
+    solver.search(timesteps, kuhn_poker);
+    auto strategy = solver.calculate_cumulative_strategy(kuhn_poker);
+
+    ASSERT_LT(best_response::calculate_exploitability(kuhn_poker, strategy).exploitability, max_exploitability);
+}
+
+TEST(CFRVariant, Discount) {
+    Discount vanilla = cfr_variants::vanilla().get_discount(9);
+    ASSERT_EQ(vanilla.positive_regret, 1.0f);
+    ASSERT_EQ(vanilla.negative_regret, 1.0f);
+    ASSERT_EQ(vanilla.strategy, 1.0f);
+
+    Discount cfr_plus = cfr_variants::cfr_plus().get_discount(9);
+    ASSERT_EQ(cfr_plus.positive_regret, 1.0f);
+    ASSERT_EQ(cfr_plus.negative_regret, 0.0f);
+    ASSERT_FLOAT_EQ(cfr_plus.strategy, 10.0f/11.0f);
+
+    Discount linear = cfr_variants::linear().get_discount(9);
+    ASSERT_FLOAT_EQ(linear.positive_regret, 10.0f/11.0f);
+    ASSERT_FLOAT_EQ(linear.negative_regret, 10.0f/11.0f);
+    ASSERT_FLOAT_EQ(linear.strategy, 10.0f/11.0f);
+
+    Discount discounted = cfr_variants::discounted(2.0, 0.0, 2.0).get_discount(9);
+    ASSERT_FLOAT_EQ(discounted.positive_regret, 100.0f/101.0f);
+    ASSERT_FLOAT_EQ(discounted.negative_regret, 0.5f);
+    ASSERT_FLOAT_EQ(discounted.strategy, 100.0f/121.0f);
+}
+
+TEST_F(LCFRTest, TwoPlayerKuhnPokerVariants) {
+    KuhnPoker kuhn_poker(2);
+    int timesteps = 200000;
+    float error_treshold = 0.03f;
+
+    for (CFRVariant variant:{cfr_variants::vanilla(), cfr_variants::cfr_plus(), cfr_variants::linear()}) {
+        solver.search(timesteps, kuhn_poker, variant);
+        auto strategy = solver.calculate_cumulative_strategy();
+        solver.clear();
+
+        ASSERT_NO_THROW(test_two_player_kuhn_poker(error_treshold, strategy));
+    }
+}
+
+TEST_F(LCFRTest, TwoPlayerKuhnPokerTreeStorage) {
+    KuhnPoker kuhn_poker(2);
+    int timesteps = 200000;
+    float error_treshold = 0.03f;
+
+    solver.storage = RegretStorage::TREE;
+    solver.search(timesteps, kuhn_poker);
+    auto strategy = solver.calculate_cumulative_strategy(kuhn_poker);
+
+    ASSERT_TRUE(solver.regret.empty());
+    ASSERT_NO_THROW(test_two_player_kuhn_poker(error_treshold, strategy));
+}
+
+TEST_F(LCFRTest, TwoPlayerKuhnPokerBlockStorage) {
+    KuhnPoker kuhn_poker(2);
+    int timesteps = 200000;
     float error_treshold = 0.03f;
 
-    lcfr::search(timesteps, kuhn_poker);
-    auto strategy = change_notation(lcfr::calculate_cumulative_strategy());
+    solver.storage = RegretStorage::BLOCK;
+    solver.search(timesteps, kuhn_poker);
+    auto strategy = solver.calculate_cumulative_strategy(kuhn_poker);
+
+    // One block for every public state where a player acts.
+    ASSERT_TRUE(solver.regret.empty());
+    ASSERT_EQ(solver.blocks.size(), 4);
+    ASSERT_NO_THROW(test_two_player_kuhn_poker(error_treshold, strategy));
+}
+
+TEST_F(LCFRTest, HoldemBlockStorage) {
+    // Hold'em has far more private states than a tree node has room for, so the blocks are sized by the game.
+    Holdem holdem({300, 300}, 50, 100);
+    solver.storage = RegretStorage::BLOCK;
+    solver.search(2, holdem);
+
+    ASSERT_TRUE(solver.regret.empty());
+    ASSERT_GT(solver.blocks.size(), 0);
+    ASSERT_EQ(solver.get_num_infosets(), solver.blocks.size() * Holdem::NUM_HOLE_CARD_COMBINATIONS);
+    for (auto const& [public_state, block]:solver.blocks) {
+        ASSERT_LE(block.num_actions, holdem.get_max_actions());
+        ASSERT_EQ(block.regret.size(), Holdem::NUM_HOLE_CARD_COMBINATIONS * block.num_actions);
+    }
+
+    std::string file_name = testing::TempDir() + "lcfr_block_checkpoint";
+    Checkpointer checkpointer(file_name);
+    solver.save_checkpoint(checkpointer, 2);
+    checkpointer.wait();
+    LCFR loaded;
+    ASSERT_EQ(loaded.load_checkpoint(checkpointer), 2);
+    std::remove(file_name.c_str());
+    ASSERT_EQ(loaded.blocks.size(), solver.blocks.size());
+    for (auto const& [public_state, block]:solver.blocks) {
+        ASSERT_EQ(loaded.blocks[public_state].regret, block.regret);
+        ASSERT_EQ(loaded.blocks[public_state].strategy, block.strategy);
+    }
+}
+
+TEST_F(LCFRTest, AnytimeSearchCancelled) {
+    KuhnPoker kuhn_poker(2);
+    CancellationToken token;
+    SearchBudget budget = SearchBudget::for_duration(std::chrono::seconds(60));
+    budget.token = &token;
+
+    std::thread canceller([&token]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        token.cancel();
+    });
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    AnytimeResult result = solver.search(kuhn_poker, cfr_variants::linear(), budget);
+    canceller.join();
 
-    ASSERT_NO_THROW(test_three_player_kuhn_poker(error_treshold, strategy));
-}
\ No newline at end of file
+    ASSERT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(10));
+    ASSERT_GT(result.statistics.iterations, 0);
+    ASSERT_GT(result.statistics.nodes, 0);
+    ASSERT_EQ(result.strategy.size(), 12);
+
+    // A cancelled token stops the search before the first iteration.
+    AnytimeResult cancelled = solver.search(kuhn_poker, cfr_variants::linear(), budget);
+    ASSERT_EQ(cancelled.statistics.iterations, 0);
+}
+
+TEST_F(LCFRTest, Telemetry) {
+    KuhnPoker kuhn_poker(2);
+    std::vector<SolverStatistics> reports;
+    Telemetry telemetry([&reports](const SolverStatistics& statistics) {
+        reports.push_back(statistics);
+    }, std::chrono::steady_clock::duration::zero());
+    solver.set_telemetry(&telemetry);
+    solver.search(10, kuhn_poker);
+
+    // Every iteration traverses the whole tree for both players.
+    ASSERT_EQ(reports.size(), 10);
+    ASSERT_EQ(reports.back().iterations, 10);
+    ASSERT_EQ(reports.back().nodes_visited, 10 * reports.front().nodes_visited);
+    ASSERT_EQ(reports.back().terminal_evaluations, 10 * reports.front().terminal_evaluations);
+    ASSERT_EQ(reports.back().pruned_branches, 0);
+    ASSERT_EQ(reports.back().num_infosets, 12);
+}
+
+TEST_F(LCFRTest, ResumeFromCheckpointTreeStorage) {
+    KuhnPoker kuhn_poker(2);
+    std::string file_name = testing::TempDir() + "lcfr_checkpoint";
+    std::remove(file_name.c_str());
+
+    solver.storage = RegretStorage::TREE;
+    solver.search(300, kuhn_poker);
+    auto strategy = solver.calculate_cumulative_strategy(kuhn_poker);
+
+    solver.clear();
+    {
+        Checkpointer checkpointer(file_name);
+        solver.search(200, kuhn_poker, cfr_variants::discounted(1.5, 0.5, 3.0), checkpointer, 50);
+    }
+    // The engine of the solver is restored from the checkpoint.
+    LCFR resumed_solver(RegretStorage::HASH_MAP, 7);
+    Checkpointer checkpointer(file_name);
+    resumed_solver.search(300, kuhn_poker, cfr_variants::discounted(1.5, 0.5, 3.0), checkpointer, 50);
+    std::remove(file_name.c_str());
+
+    ASSERT_EQ(resumed_solver.storage, RegretStorage::TREE);
+    ASSERT_TRUE(resumed_solver.regret.empty());
+    auto resumed_strategy = resumed_solver.calculate_cumulative_strategy(kuhn_poker);
+    ASSERT_EQ(resumed_strategy.size(), strategy.size());
+    for (auto const& [infoset, infoset_strategy]:strategy)
+        for (auto const& [action, probability]:infoset_strategy)
+            ASSERT_EQ(resumed_strategy[infoset][action], probability);
+}
@@ -1,13 +1,15 @@
 #include "optimal_strategies_tests.h"
-#include "../src/mccfr.cpp"
+#include "../src/mccfr.h"
+#include "../src/kuhn_poker.h"
+#include "../src/holdem.h"
+#include <thread>
+#include <fstream>
 
 struct MCCFRTest: public testing::Test {
-    MCCFRTest() {
-        srand(42);
-    };
-    ~MCCFRTest() {
-        mccfr::regret.clear();
-        mccfr::strategy.clear();
+    MCCFR solver;
+
+    MCCFRTest() : solver{RegretStorage::HASH_MAP, 42} {
+        random_engine.seed(42);
     };
 };
 
@@ -16,8 +18,8 @@ TEST_F(MCCFRTest, TwoPlayerKuhnPokerOptimalStrategy) {
     KuhnPoker kuhn_poker(2);
     float error_treshold = 0.03f;
 
-    mccfr::mccfr_p(100000, 1, 20000, 1000, 20, kuhn_poker);
-    auto strategy = mccfr::calculate_probabilities();
+    solver.mccfr_p(100000, 1, 20000, 1000, 20, kuhn_poker);
+    auto strategy = solver.calculate_probabilities();
 
     ASSERT_NO_THROW(test_two_player_kuhn_poker(error_treshold, strategy));
 }
@@ -28,8 +30,287 @@ TEST_F(MCCFRTest, ThreePlayerKuhnPokerOptimalStrategy) {
     KuhnPoker kuhn_poker(3);
     float error_treshold = 0.03f;
 
-    mccfr::mccfr_p(10000000, 1000, 20000000, 20000000, 10000000, kuhn_poker);
-    auto strategy = change_notation(mccfr::calculate_probabilities());
+    solver.mccfr_p(10000000, 1000, 20000000, 20000000, 10000000, kuhn_poker);
+    auto strategy = change_notation(solver.calculate_probabilities());
 
     ASSERT_NO_THROW(test_three_player_kuhn_poker(error_treshold, strategy));
 }
+
+TEST_F(MCCFRTest, TwoPlayerKuhnPokerTreeStorage) {
+    KuhnPoker kuhn_poker(2);
+    float error_treshold = 0.03f;
+
+    solver.storage = RegretStorage::TREE;
+    solver.mccfr_p(100000, 1, 20000, 1000, 20, kuhn_poker);
+    auto strategy = solver.calculate_probabilities(kuhn_poker);
+
+    ASSERT_TRUE(solver.regret.empty());
+    ASSERT_NO_THROW(test_two_player_kuhn_poker(error_treshold, strategy));
+}
+
+TEST_F(MCCFRTest, TreeStorageAssertions) {
+    // A tree node has a row for every private state, and no branches for the chance outcomes.
+    Holdem holdem({300, 300}, 50, 100);
+    solver.storage = RegretStorage::TREE;
+
+    ASSERT_DEATH(solver.mccfr_p(1, 1, 20000, 1000, 20, holdem), "Tree storage has room for the private states.");
+}
+
+TEST_F(MCCFRTest, HoldemQuantizedStorage) {
+    // Hold'em with the default pot-sized raise has three actions where a player faces a bet.
+    Holdem holdem({300, 300}, 50, 100);
+    solver.storage = RegretStorage::QUANTIZED;
+    solver.mccfr_p(100, 1, 20000, 1000, 20, holdem);
+    int max_actions = 0;
+    solver.quantized.for_each([&max_actions](uint64_t infoset, QuantizedInfoset& record) {
+        max_actions = std::max(max_actions, static_cast<int>(record.num_actions));
+    });
+
+    ASSERT_EQ(holdem.get_max_actions(), 3);
+    ASSERT_EQ(max_actions, 3);
+
+    // A menu with more sizes than the records have room for is rejected before training. With
+    // MAX_MOVES raise sizes, fold and call do not fit whatever MAX_MOVES is.
+    std::vector<float> raise_sizes;
+    for (int x=0; x<MAX_MOVES; ++x)
+        raise_sizes.push_back(0.5f * static_cast<float>(x + 1));
+    ActionAbstraction abstraction;
+    for (int round=0; round<Holdem::NUM_ROUNDS; ++round)
+        abstraction.set_raise_sizes(round, 0, raise_sizes);
+    Holdem wide_holdem({300, 300}, 50, 100, abstraction);
+    solver.clear();
+
+    ASSERT_GT(wide_holdem.get_max_actions(), MAX_MOVES);
+    ASSERT_DEATH(solver.mccfr_p(1, 1, 20000, 1000, 20, wide_holdem), "The storage has room for the actions.");
+}
+
+TEST_F(MCCFRTest, TwoPlayerKuhnPokerQuantizedStorage) {
+    KuhnPoker kuhn_poker(2);
+    float error_treshold = 0.03f;
+
+    solver.storage = RegretStorage::QUANTIZED;
+    solver.quantization = RegretQuantization{1000.0f, -2000000.0f};
+    solver.mccfr_p(100000, 1, 20000, 1000, 20, kuhn_poker);
+    auto strategy = solver.calculate_probabilities(kuhn_poker);
+    float memory_per_infoset = solver.get_memory_per_infoset();
+    MCCFR hash_map_solver;
+    hash_map_solver.mccfr_p(100, 1, 20000, 1000, 20, kuhn_poker);
+
+    ASSERT_TRUE(hash_map_solver.quantized.empty());
+    ASSERT_LT(memory_per_infoset, hash_map_solver.get_memory_per_infoset());
+    ASSERT_NO_THROW(test_two_player_kuhn_poker(error_treshold, strategy));
+}
+
+TEST_F(MCCFRTest, AnytimeSearch) {
+    KuhnPoker kuhn_poker(2);
+    solver.mccfr_p(4000, 1, 2000, 1000, 20, kuhn_poker);
+    auto strategy = solver.calculate_probabilities(kuhn_poker);
+
+    // With only an iteration limit, the anytime search runs the same iterations. Clearing the
+    // solver seeds its engine again.
+    solver.clear();
+    SearchBudget budget;
+    budget.max_iterations = 4000;
+    AnytimeResult result = solver.mccfr_p(1, 2000, 1000, 20, kuhn_poker, budget);
+
+    ASSERT_EQ(result.statistics.iterations, 4000);
+    ASSERT_GT(result.statistics.nodes, 4000);
+    ASSERT_EQ(result.strategy.size(), strategy.size());
+    for (auto const& [infoset, infoset_strategy]:strategy)
+        for (auto const& [action, probability]:infoset_strategy)
+            ASSERT_EQ(result.strategy[infoset][action], probability);
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    result = solver.mccfr_p(1, 2000, 1000, 20, kuhn_poker, SearchBudget::for_duration(std::chrono::milliseconds(50)));
+    ASSERT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(1));
+    ASSERT_GT(result.statistics.iterations, 0);
+    ASSERT_GT(result.statistics.get_nodes_per_second(), 0.0);
+}
+
+TEST_F(MCCFRTest, Telemetry) {
+    // With no interval, every iteration is reported.
+    KuhnPoker kuhn_poker(2);
+    std::vector<SolverStatistics> reports;
+    Telemetry telemetry([&reports](const SolverStatistics& statistics) {
+        reports.push_back(statistics);
+    }, std::chrono::steady_clock::duration::zero());
+    solver.set_telemetry(&telemetry);
+    solver.mccfr_p(1000, 1, 500, 1000, 20, kuhn_poker);
+    solver.set_telemetry(nullptr);
+    solver.mccfr_p(1100, 1, 500, 1000, 20, kuhn_poker);
+
+    ASSERT_EQ(reports.size(), 1000);
+    SolverStatistics& last = reports.back();
+    ASSERT_EQ(last.timestep, 1000);
+    ASSERT_EQ(last.iterations, 1000);
+    ASSERT_GT(last.terminal_evaluations, 0);
+    ASSERT_LT(last.terminal_evaluations, last.nodes_visited);
+    // The regrets of Kuhn poker never fall below the pruning treshold.
+    ASSERT_EQ(last.pruned_branches, 0);
+    ASSERT_EQ(last.num_infosets, 12);
+    ASSERT_GT(last.memory, 0);
+    ASSERT_GT(last.nodes_per_second, 0.0);
+}
+
+TEST(RegretQuantization, Quantize) {
+    RegretQuantization quantization{10.0f, -5.0f};
+
+    ASSERT_EQ(quantization.quantize(1.26f), 13);
+    ASSERT_EQ(quantization.quantize(-100.0f), -50);
+    ASSERT_EQ(quantization.quantize(1.0e9f), std::numeric_limits<int32_t>::max());
+    ASSERT_FLOAT_EQ(quantization.dequantize(-13), -1.3f);
+    ASSERT_FLOAT_EQ(quantization.get_prune_threshold(), -5.0f * 300.0f / 310.0f);
+    // A floor that is clamped by the integers would never reach the pruning threshold.
+    ASSERT_DEATH(RegretQuantization(1000.0f, -310000000.0f), "The scaled floor fits in the quantized regrets.");
+}
+
+TEST_F(MCCFRTest, QuantizedStoragePruning) {
+    // With a floor close to zero, the regrets of bad actions reach the scaled pruning threshold.
+    KuhnPoker kuhn_poker(2);
+    solver.storage = RegretStorage::QUANTIZED;
+    solver.quantization = RegretQuantization{1000.0f, -1.0f};
+    solver.mccfr_p(2000, 1, 100, 1000, 20, kuhn_poker);
+
+    ASSERT_GT(solver.pruned_branches, 0);
+}
+
+TEST(RandomEngine, SameSequenceAsRand) {
+    for (uint32_t seed:{1U, 42U, 3000000000U}) {
+        srand(seed);
+        random_engine.seed(seed);
+        for (int x=0; x<1000; ++x)
+            ASSERT_EQ(random_engine(), static_cast<uint32_t>(rand()));
+    }
+}
+
+TEST_F(MCCFRTest, ResumeFromCheckpoint) {
+    KuhnPoker kuhn_poker(2);
+    std::string file_name = testing::TempDir() + "mccfr_checkpoint";
+    std::remove(file_name.c_str());
+
+    solver.mccfr_p(4000, 1, 2000, 1000, 20, kuhn_poker);
+    auto regret = solver.regret;
+    auto strategy = solver.strategy;
+
+    solver.clear();
+    {
+        Checkpointer checkpointer(file_name);
+        solver.mccfr_p(3000, 1, 2000, 1000, 20, kuhn_poker, checkpointer, 1000);
+    }
+    // The engine of the solver is restored from the checkpoint.
+    solver.clear();
+    solver.rng.seed(7);
+    Checkpointer checkpointer(file_name);
+    solver.mccfr_p(4000, 1, 2000, 1000, 20, kuhn_poker, checkpointer, 1000);
+    std::remove(file_name.c_str());
+
+    ASSERT_EQ(solver.regret.size(), regret.size());
+    for (auto const& [infoset, infoset_regret]:regret)
+        for (auto const& [action, action_regret]:infoset_regret) {
+            ASSERT_EQ(solver.regret[infoset][action], action_regret);
+            ASSERT_EQ(solver.strategy[infoset][action], strategy[infoset][action]);
+        }
+}
+
+TEST_F(MCCFRTest, InvalidCheckpoint) {
+    KuhnPoker kuhn_poker(2);
+    std::string file_name = testing::TempDir() + "mccfr_invalid_checkpoint";
+    std::remove(file_name.c_str());
+    {
+        Checkpointer checkpointer(file_name);
+        solver.mccfr_p(100, 1, 2000, 1000, 20, kuhn_poker, checkpointer, 1000);
+    }
+    std::vector<char> buffer = Checkpointer(file_name).read();
+
+    // Every prefix of the checkpoint is rejected instead of being read past its end.
+    for (size_t size:{size_t(0), size_t(10), buffer.size() / 2, buffer.size() - 1}) {
+        std::ofstream(file_name, std::ios::binary | std::ios::trunc).write(buffer.data(), size);
+        Checkpointer checkpointer(file_name);
+        ASSERT_THROW(solver.load_checkpoint(checkpointer), std::runtime_error);
+    }
+    std::ofstream(file_name, std::ios::binary | std::ios::trunc) << std::string(buffer.size(), 'x');
+    Checkpointer checkpointer(file_name);
+    ASSERT_THROW(solver.load_checkpoint(checkpointer), std::runtime_error);
+
+    // The storage follows the header and the random engine, and an unknown one is rejected.
+    size_t storage_position = sizeof(uint64_t) + 5 * sizeof(uint32_t) + sizeof(Rng::state) + 2 * sizeof(int32_t);
+    int unknown_storage = 7;
+    std::memcpy(buffer.data() + storage_position, &unknown_storage, sizeof(unknown_storage));
+    std::ofstream(file_name, std::ios::binary | std::ios::trunc).write(buffer.data(), buffer.size());
+    ASSERT_THROW(solver.load_checkpoint(checkpointer), std::runtime_error);
+    std::remove(file_name.c_str());
+}
+
+TEST_F(MCCFRTest, CheckpointSnapshot) {
+    // The checkpoint has the state at the time it was saved, even though training goes on while it is written.
+    KuhnPoker kuhn_poker(2);
+    std::string file_name = testing::TempDir() + "mccfr_snapshot_checkpoint";
+    solver.mccfr_p(1000, 1, 2000, 1000, 20, kuhn_poker);
+    auto regret = solver.regret;
+    Checkpointer checkpointer(file_name);
+    solver.save_checkpoint(checkpointer, 1000);
+    solver.train(1000, 2000, 1, 2000, 1000, 20, kuhn_poker, nullptr, 0);
+    checkpointer.wait();
+    MCCFR loaded;
+    ASSERT_EQ(loaded.load_checkpoint(checkpointer), 1000);
+    std::remove(file_name.c_str());
+
+    ASSERT_EQ(loaded.regret.size(), regret.size());
+    for (auto const& [infoset, infoset_regret]:regret)
+        for (auto const& [action, action_regret]:infoset_regret)
+            ASSERT_EQ(loaded.regret[infoset][action], action_regret);
+}
+
+TEST(Checkpointer, WriteFailure) {
+    // The failure is reported once, by the next wait.
+    Checkpointer checkpointer(testing::TempDir() + "missing_directory/checkpoint");
+    checkpointer.write([](std::vector<char>& buffer) { buffer.push_back(0); });
+
+    ASSERT_THROW(checkpointer.wait(), std::runtime_error);
+    ASSERT_NO_THROW(checkpointer.wait());
+}
+
+TEST(MCCFRSolvers, IndependentSolvers) {
+    // Solvers on different threads share no state, so they train the same as one solver alone.
+    auto train = [](robin_hood::unordered_map<uint64_t, robin_hood::unordered_map<Move, float>>& strategy) {
+        KuhnPoker kuhn_poker(2);
+        MCCFR solver(RegretStorage::HASH_MAP, 42);
+        solver.mccfr_p(4000, 1, 2000, 1000, 20, kuhn_poker);
+        strategy = solver.calculate_probabilities(kuhn_poker);
+    };
+    robin_hood::unordered_map<uint64_t, robin_hood::unordered_map<Move, float>> strategy, first_strategy, second_strategy;
+    train(strategy);
+    std::thread first(train, std::ref(first_strategy));
+    std::thread second(train, std::ref(second_strategy));
+    first.join();
+    second.join();
+
+    ASSERT_EQ(first_strategy.size(), strategy.size());
+    ASSERT_EQ(second_strategy.size(), strategy.size());
+    for (auto const& [infoset, infoset_strategy]:strategy)
+        for (auto const& [action, probability]:infoset_strategy) {
+            ASSERT_EQ(first_strategy[infoset][action], probability);
+            ASSERT_EQ(second_strategy[infoset][action], probability);
+        }
+}
+
+TEST(MCCFRSolvers, InterleavedSolvers) {
+    // Solvers on one thread sample from their own engines, so taking turns changes nothing.
+    KuhnPoker kuhn_poker(2);
+    MCCFR solver(RegretStorage::HASH_MAP, 42), first(RegretStorage::HASH_MAP, 42), second(RegretStorage::HASH_MAP, 42);
+    solver.mccfr_p(4000, 1, 2000, 1000, 20, kuhn_poker);
+    for (int timestep=0; timestep<4000; timestep+=100) {
+        first.train(timestep, timestep + 100, 1, 2000, 1000, 20, kuhn_poker, nullptr, 0);
+        second.train(timestep, timestep + 100, 1, 2000, 1000, 20, kuhn_poker, nullptr, 0);
+    }
+
+    ASSERT_EQ(first.regret.size(), solver.regret.size());
+    ASSERT_EQ(second.regret.size(), solver.regret.size());
+    for (auto const& [infoset, infoset_regret]:solver.regret)
+        for (auto const& [action, action_regret]:infoset_regret) {
+            ASSERT_EQ(first.regret[infoset][action], action_regret);
+            ASSERT_EQ(second.regret[infoset][action], action_regret);
+            ASSERT_EQ(first.strategy[infoset][action], solver.strategy[infoset][action]);
+            ASSERT_EQ(second.strategy[infoset][action], solver.strategy[infoset][action]);
+        }
+}
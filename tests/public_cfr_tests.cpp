@@ -0,0 +1,84 @@
+#include "optimal_strategies_tests.h"
+#include "../src/public_cfr.h"
+#include "../src/holdem.h"
+
+struct PublicCFRTest: public testing::Test {
+    PublicCFR solver;
+
+    PublicCFRTest() {
+        random_engine.seed(42);
+    };
+};
+
+TEST_F(PublicCFRTest, EnumerateDeals) {
+    KuhnPoker two_player_kuhn_poker(2);
+    KuhnPoker three_player_kuhn_poker(3);
+
+    ASSERT_EQ(public_tree::enumerate_deals(two_player_kuhn_poker).size(), 3*2*2);
+    ASSERT_EQ(public_tree::enumerate_deals(three_player_kuhn_poker).size(), 4*3*2*3);
+}
+
+TEST_F(PublicCFRTest, EnumerateInfosets) {
+    KuhnPoker two_player_kuhn_poker(2);
+    KuhnPoker three_player_kuhn_poker(3);
+
+    std::vector<std::vector<uint64_t>> two_player_infosets = public_tree::enumerate_infosets(two_player_kuhn_poker);
+    ASSERT_EQ(two_player_infosets[0].size(), 6);
+    ASSERT_EQ(two_player_infosets[1].size(), 6);
+
+    std::vector<std::vector<uint64_t>> three_player_infosets = public_tree::enumerate_infosets(three_player_kuhn_poker);
+    ASSERT_EQ(three_player_infosets[0].size() + three_player_infosets[1].size() + three_player_infosets[2].size(), 48);
+}
+
+TEST_F(PublicCFRTest, TwoPlayerKuhnPokerOptimalStrategy) {
+    // The optimal strategy for two player Kuhn poker is described here: https://en.wikipedia.org/wiki/Kuhn_poker#Optimal_strategy
+    KuhnPoker kuhn_poker(2);
+    int timesteps = 10000;
+    float error_treshold = 0.03f;
+
+    solver.search(timesteps, kuhn_poker);
+    auto strategy = solver.calculate_cumulative_strategy(kuhn_poker);
+
+    ASSERT_NO_THROW(test_two_player_kuhn_poker(error_treshold, strategy));
+}
+
+TEST_F(PublicCFRTest, ThreePlayerKuhnPokerOptimalStrategy) {
+    // The optimal strategy for three player Kuhn poker is described here: https://poker.cs.ualberta.ca/publications/AAMAS13-3pkuhn.pdf
+    // The variables are using the notation from the paper.
+    KuhnPoker kuhn_poker(3);
+    int timesteps = 100000;
+    float error_treshold = 0.03f;
+
+    solver.search(timesteps, kuhn_poker);
+    auto strategy = change_notation(solver.calculate_cumulative_strategy(kuhn_poker));
+
+    ASSERT_NO_THROW(test_three_player_kuhn_poker(error_treshold, strategy));
+}
+
+TEST_F(PublicCFRTest, TwoPlayerKuhnPokerVariants) {
+    KuhnPoker kuhn_poker(2);
+    int timesteps = 10000;
+    float error_treshold = 0.03f;
+
+    for (CFRVariant variant:{cfr_variants::vanilla(), cfr_variants::cfr_plus(), cfr_variants::linear()}) {
+        solver.search(timesteps, kuhn_poker, variant);
+        auto strategy = solver.calculate_cumulative_strategy(kuhn_poker);
+        solver.clear();
+
+        ASSERT_NO_THROW(test_two_player_kuhn_poker(error_treshold, strategy));
+    }
+}
+
+TEST_F(PublicCFRTest, ChanceNodes) {
+    // After the small blind calls and the big blind checks, the flop is dealt.
+    Holdem holdem({300, 300}, 50, 100);
+    Move call = Move::C;
+    holdem.execute(call);
+    holdem.execute(call);
+    std::vector<Range> reach(holdem.get_num_players());
+    Range values;
+    Discount discount = cfr_variants::vanilla().get_discount(0);
+
+    ASSERT_TRUE(holdem.is_chance_node());
+    ASSERT_THROW(solver.cfr(holdem, nullptr, 0, reach, values, discount), std::runtime_error);
+}
@@ -0,0 +1,82 @@
+#include "gtest/gtest.h"
+#include "../src/sharded_table.h"
+#include <thread>
+
+
+TEST(ShardedTableTest, Shards) {
+    ShardedTable<float> table(6);
+
+    ASSERT_EQ(table.get_num_shards(), 8);
+    for (uint64_t key=0; key<1000; ++key)
+        table[key] = static_cast<float>(key);
+
+    ASSERT_EQ(table.size(), 1000);
+    for (uint64_t key=0; key<1000; ++key) {
+        ASSERT_GE(table.get_shard(key), 0);
+        ASSERT_LT(table.get_shard(key), 8);
+        ASSERT_EQ(table[key], static_cast<float>(key));
+    }
+}
+
+TEST(ShardedTableTest, SpreadOverShards) {
+    // Keys that only differ in their high bits, like infosets with different histories, are spread as well.
+    ShardedTable<float> table(4);
+    std::vector<int> num_keys(table.get_num_shards(), 0);
+
+    for (uint64_t key=0; key<4000; ++key)
+        ++num_keys[table.get_shard(key << 32)];
+
+    for (int shard=0; shard<table.get_num_shards(); ++shard)
+        ASSERT_NEAR(num_keys[shard], 1000, 100);
+}
+
+TEST(ShardedTableTest, PlaceOnNodes) {
+    ShardedTable<float> table(4);
+    for (uint64_t key=0; key<1000; ++key)
+        table[key] = static_cast<float>(key);
+
+    table.place_on_nodes(2);
+
+    ASSERT_EQ(table.size(), 1000);
+    for (int shard=0; shard<table.get_num_shards(); ++shard)
+        ASSERT_EQ(table.get_node(shard), shard % 2);
+    for (uint64_t key=0; key<1000; ++key)
+        ASSERT_EQ(table[key], static_cast<float>(key));
+}
+
+TEST(ShardedTableTest, AccessCounts) {
+    ShardedTable<float> table(2);
+    table.place_on_nodes(2);
+
+    std::thread([&table]() {
+        numa_topology::pin_thread_to_node(1);
+        for (uint64_t key=0; key<1000; ++key)
+            table[key] += 1.0f;
+    }).join();
+
+    AccessCounts counts = table.get_access_counts();
+    int num_local = 0;
+    for (uint64_t key=0; key<1000; ++key)
+        num_local += table.get_node(table.get_shard(key)) == 1;
+    ASSERT_EQ(counts.local, num_local);
+    ASSERT_EQ(counts.remote, 1000 - num_local);
+}
+
+TEST(ShardedTableTest, ConcurrentInsert) {
+    int num_threads = 8;
+    ShardedTable<float> table(4);
+
+    std::vector<std::thread> threads;
+    for (int thread=0; thread<num_threads; ++thread)
+        threads.emplace_back([&table, thread, num_threads]() {
+            for (uint64_t key=thread; key<10000; key+=num_threads)
+                table[key] = static_cast<float>(key);
+        });
+    for (std::thread& thread:threads)
+        thread.join();
+
+    ASSERT_EQ(table.size(), 10000);
+    table.for_each([](uint64_t key, float& value) {
+        ASSERT_EQ(value, static_cast<float>(key));
+    });
+}
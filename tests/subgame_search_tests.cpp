@@ -0,0 +1,250 @@
+#include "gtest/gtest.h"
+#include "../src/kuhn_poker.h"
+#include "../src/holdem.h"
+#include "../src/public_tree.h"
+#include "../src/subgame_search.h"
+#include "../src/leaf_evaluator.h"
+#include <thread>
+
+struct SubgameSearchTest: public testing::Test {
+    SubgameSearch searcher;
+
+    SubgameSearchTest() : searcher{42} {
+        random_engine.seed(42);
+    };
+};
+
+TEST_F(SubgameSearchTest, Beliefs) {
+    // The blueprint only bets with an ace, so a bet reveals the card of the first player.
+    robin_hood::unordered_map<uint64_t, robin_hood::unordered_map<Move, float>> blueprint;
+    blueprint[to_infoset("", Cards::A)] = {{Move::C, 0.0f}, {Move::R, 1.0f}};
+    blueprint[to_infoset("", Cards::K)] = {{Move::C, 1.0f}, {Move::R, 0.0f}};
+    blueprint[to_infoset("", Cards::Q)] = {{Move::C, 1.0f}, {Move::R, 0.0f}};
+    KuhnPoker kuhn_poker(2);
+    Game& game = kuhn_poker;
+    game.set_private_state(0, 0);
+    game.set_private_state(1, 2);
+    Move bet = Move::R;
+    game.execute(bet);
+
+    std::vector<int> deals = public_tree::enumerate_deals(game);
+    std::vector<float> beliefs = subgame_search::calculate_beliefs(game, {Move::R}, blueprint, deals);
+
+    for (int deal=0; deal<beliefs.size(); ++deal)
+        ASSERT_FLOAT_EQ(beliefs[deal], deals[2*deal] == 0 ? 0.5f : 0.0f);
+    ASSERT_EQ(game.get_private_state(0), 0);
+    ASSERT_EQ(game.get_private_state(1), 2);
+    ASSERT_EQ(game.get_current_infoset(), to_infoset("R", Cards::Q));
+}
+
+TEST_F(SubgameSearchTest, SampledDeals) {
+    // Two hold'em players have 1326 * 1325 deals of hole cards, which are sampled instead of
+    // enumerated. The flop is dealt inside the subgame, and the cards to come are drawn around
+    // the hole cards of the game again when the search is done.
+    robin_hood::unordered_map<uint64_t, robin_hood::unordered_map<Move, float>> blueprint;
+    Holdem holdem({300, 300}, 50, 100);
+    Game& game = holdem;
+    SearchConfig config;
+    config.max_depth = 3;
+    config.max_iterations = 20;
+    config.num_continuations = 2;
+    config.num_rollouts = 2;
+    config.time_budget = std::chrono::seconds(60);
+    unsigned long long hole_cards = holdem.get_hole_cards(0) | holdem.get_hole_cards(1);
+    uint64_t infoset = game.get_current_infoset();
+
+    ASSERT_GT(public_tree::count_deals(holdem), subgame_search::MAX_DEALS);
+    SearchResult result = searcher.search(game, {}, blueprint, config);
+
+    ASSERT_EQ(result.iterations, config.max_iterations);
+    float sum = 0.0f;
+    for (auto const& [action, probability]:result.strategy)
+        sum += probability;
+    ASSERT_NEAR(sum, 1.0f, 1e-5f);
+    ASSERT_EQ(holdem.get_hole_cards(0) | holdem.get_hole_cards(1), hole_cards);
+    ASSERT_EQ(game.get_current_infoset(), infoset);
+    Move call = Move::C, deal = Move::NONE;
+    game.execute(call);
+    game.execute(call);
+    game.execute(deal);
+    ASSERT_EQ(holdem.get_board() & hole_cards, 0ULL);
+}
+
+TEST_F(SubgameSearchTest, ChanceNodesInHistory) {
+    // Replaying the history deals the same flop again, and the deals that share a card with it are ruled out.
+    robin_hood::unordered_map<uint64_t, robin_hood::unordered_map<Move, float>> blueprint;
+    Holdem holdem({300, 300}, 50, 100);
+    Game& game = holdem;
+    Move call = Move::C, deal = Move::NONE;
+    game.execute(call);
+    game.execute(call);
+    game.execute(deal);
+    unsigned long long board = holdem.get_board();
+    uint64_t infoset = game.get_current_infoset();
+    SearchConfig config;
+    config.max_depth = 2;
+    config.max_iterations = 20;
+    config.num_continuations = 2;
+    config.num_rollouts = 2;
+    config.time_budget = std::chrono::seconds(60);
+
+    int private_state = game.get_private_state(1);
+    ASSERT_GT(subgame_search::calculate_reach(game, {Move::C, Move::C, Move::NONE}, blueprint), 0.0f);
+    game.set_private_state(1, game.get_private_state(0));
+    ASSERT_EQ(subgame_search::calculate_reach(game, {Move::C, Move::C, Move::NONE}, blueprint), 0.0f);
+    game.set_private_state(1, private_state);
+    SearchResult result = searcher.search(game, {Move::C, Move::C, Move::NONE}, blueprint, config);
+
+    ASSERT_EQ(result.iterations, config.max_iterations);
+    ASSERT_EQ(holdem.get_board(), board);
+    ASSERT_EQ(game.get_current_infoset(), infoset);
+}
+
+TEST_F(SubgameSearchTest, TooManyActions) {
+    robin_hood::unordered_map<uint64_t, robin_hood::unordered_map<Move, float>> blueprint;
+    ActionAbstraction abstraction;
+    for (int round=0; round<Holdem::NUM_ROUNDS; ++round)
+        abstraction.set_raise_sizes(round, 0, {0.25f, 0.5f, 1.0f, ActionAbstraction::ALL_IN});
+    Holdem holdem({10000, 10000}, 50, 100, abstraction);
+
+    ASSERT_GT(holdem.get_max_actions(), MAX_SUBGAME_ACTIONS);
+    ASSERT_DEATH(searcher.search(holdem, {}, blueprint, SearchConfig()), "The infosets have room for the actions.");
+}
+
+TEST_F(SubgameSearchTest, FacingABet) {
+    // Without a depth limit the subgame is solved to the end, where calling a bet with the best
+    // card and folding the worst card are dominant.
+    robin_hood::unordered_map<uint64_t, robin_hood::unordered_map<Move, float>> blueprint;
+    KuhnPoker kuhn_poker(2);
+    Game& game = kuhn_poker;
+    SearchConfig config;
+    config.max_depth = 10;
+    config.max_iterations = 1000;
+    config.time_budget = std::chrono::seconds(60);
+    Move bet = Move::R;
+    game.execute(bet);
+
+    game.set_private_state(1, 0);
+    SearchResult ace = searcher.search(game, {Move::R}, blueprint, config);
+    game.set_private_state(1, 2);
+    SearchResult queen = searcher.search(game, {Move::R}, blueprint, config);
+
+    ASSERT_EQ(ace.action, Move::C);
+    ASSERT_EQ(queen.action, Move::F);
+    ASSERT_EQ(queen.iterations, config.max_iterations);
+    ASSERT_GT(queen.strategy[Move::F], 0.95f);
+}
+
+TEST_F(SubgameSearchTest, TimeBudget) {
+    robin_hood::unordered_map<uint64_t, robin_hood::unordered_map<Move, float>> blueprint;
+    KuhnPoker kuhn_poker(3);
+    Game& game = kuhn_poker;
+    SearchConfig config;
+    config.max_depth = 1;
+    config.time_budget = std::chrono::milliseconds(50);
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    SearchResult result = searcher.search(game, {}, blueprint, config);
+
+    ASSERT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(1));
+    ASSERT_GT(result.iterations, 0);
+    ASSERT_EQ(result.strategy.size(), 2);
+    // The leaves below the root are valued with the continuation strategies of all three players.
+    ASSERT_FALSE(searcher.continuations.empty());
+}
+
+TEST_F(SubgameSearchTest, Multithreaded) {
+    robin_hood::unordered_map<uint64_t, robin_hood::unordered_map<Move, float>> blueprint;
+    KuhnPoker kuhn_poker(2);
+    Game& game = kuhn_poker;
+    SearchConfig config;
+    config.max_depth = 10;
+    config.max_iterations = 4000;
+    config.time_budget = std::chrono::seconds(60);
+    config.num_threads = 4;
+    Move bet = Move::R;
+    game.execute(bet);
+
+    game.set_private_state(1, 2);
+    SearchResult queen = searcher.search(game, {Move::R}, blueprint, config);
+
+    // Every iteration is run once, and the copies of the game leave the original untouched.
+    ASSERT_EQ(queen.iterations, config.max_iterations);
+    ASSERT_EQ(queen.action, Move::F);
+    ASSERT_EQ(game.get_current_infoset(), to_infoset("R", Cards::Q));
+}
+
+TEST(SubgameInfoset, ConcurrentUpdates) {
+    // Updates of the same infoset from several threads are all kept.
+    SubgameInfoset data;
+    std::vector<float> probabilities = {0.5f, 0.5f};
+    std::vector<float> values = {1.0f, -1.0f};
+    Discount discount{1.0f, 1.0f, 1.0f};
+    int num_threads = 4, num_updates = 10000;
+    std::vector<std::thread> threads;
+    for (int thread=0; thread<num_threads; ++thread)
+        threads.emplace_back([&]() {
+            std::vector<float> thread_probabilities = probabilities, thread_values = values;
+            for (int x=0; x<num_updates; ++x)
+                subgame_search::update(data, thread_probabilities, thread_values, 0.0f, 1.0f, 2.0f, discount);
+        });
+    for (std::thread& thread:threads)
+        thread.join();
+
+    ASSERT_EQ(data.regret[0].load(), static_cast<float>(num_threads * num_updates));
+    ASSERT_EQ(data.regret[1].load(), -static_cast<float>(num_threads * num_updates));
+    ASSERT_EQ(data.strategy[0].load(), static_cast<float>(num_threads * num_updates));
+}
+
+TEST(LeafEvaluator, CachedRollouts) {
+    // After a check, the blueprint always checks back, so the leaf is a showdown.
+    robin_hood::unordered_map<uint64_t, robin_hood::unordered_map<Move, float>> blueprint;
+    for (Cards card:{Cards::A, Cards::K, Cards::Q}) {
+        blueprint[to_infoset("C", card)] = {{Move::C, 1.0f}, {Move::R, 0.0f}};
+        blueprint[to_infoset("CR", card)] = {{Move::F, 1.0f}, {Move::C, 0.0f}};
+    }
+    KuhnPoker kuhn_poker(2);
+    Game& game = kuhn_poker;
+    game.set_private_state(0, 0);
+    game.set_private_state(1, 2);
+    Move check = Move::C;
+    game.execute(check);
+    LeafEvaluator evaluator(blueprint, 5.0f, 64, 42);
+    std::vector<int> blueprint_continuations = {0, 0};
+    std::vector<int> raise_continuations = {0, 3};
+
+    ASSERT_EQ(evaluator.evaluate(game, 0, blueprint_continuations), 1.0f);
+    ASSERT_EQ(evaluator.evaluate(game, 1, blueprint_continuations), -1.0f);
+    ASSERT_EQ(evaluator.get_cache_hits(), 1);
+    ASSERT_EQ(evaluator.get_cache_misses(), 1);
+
+    // The bias scales the blueprint probabilities, so an action that the blueprint never plays stays unplayed.
+    ASSERT_EQ(evaluator.evaluate(game, 1, raise_continuations), -1.0f);
+    ASSERT_EQ(evaluator.get_cache_size(), 2);
+    ASSERT_EQ(game.get_current_infoset(), to_infoset("C", Cards::Q));
+}
+
+TEST(LeafEvaluator, ChanceOutcomesPerRollout) {
+    // After an all-in and a call, the rest of the hand is dealing the board. A single board for
+    // the whole batch would give all the rollouts the same outcome.
+    robin_hood::unordered_map<uint64_t, robin_hood::unordered_map<Move, float>> blueprint;
+    random_engine.seed(42);
+    Holdem holdem({300, 300}, 50, 100);
+    Game& game = holdem;
+    std::vector<Move> actions;
+    game.get_actions(actions);
+    game.execute(actions.back());
+    Move call = Move::C;
+    game.execute(call);
+    ASSERT_TRUE(game.is_chance_node());
+    LeafEvaluator evaluator(blueprint, 5.0f, 256, 42);
+    std::vector<int> continuations = {0, 0};
+
+    float value = evaluator.evaluate(game, 0, continuations);
+    ASSERT_GT(value, -300.0f);
+    ASSERT_LT(value, 300.0f);
+    ASSERT_NE(value, 0.0f);
+    ASSERT_EQ(evaluator.evaluate(game, 1, continuations), -value);
+    ASSERT_EQ(holdem.get_board(), 0);
+    ASSERT_TRUE(game.is_chance_node());
+}
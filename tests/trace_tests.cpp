@@ -0,0 +1,40 @@
+#include "gtest/gtest.h"
+#include "../src/trace.h"
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+TEST(Trace, NestedScopes) {
+    trace::clear();
+    {
+        TRACE_SCOPE("outer");
+        TRACE_SCOPE("inner");
+    }
+    std::thread thread([]() {
+        TRACE_SCOPE("thread");
+    });
+    thread.join();
+
+    // A scope is recorded when it ends, so the inner scope comes first.
+    std::vector<TraceEvent>& events = trace::get_buffer().events;
+    ASSERT_EQ(events.size(), 2);
+    ASSERT_STREQ(events[0].name, "inner");
+    ASSERT_STREQ(events[1].name, "outer");
+    ASSERT_LE(events[1].start, events[0].start);
+    ASSERT_GE(events[1].start + events[1].duration, events[0].start + events[0].duration);
+
+    std::string file_name = testing::TempDir() + "trace.json";
+    trace::write(file_name);
+    std::ifstream ifs(file_name);
+    std::stringstream contents;
+    contents << ifs.rdbuf();
+    std::remove(file_name.c_str());
+    std::string json = contents.str();
+
+    int num_events = 0;
+    for (size_t position = json.find("\"ph\":\"X\""); position != std::string::npos; position = json.find("\"ph\":\"X\"", position + 1))
+        ++num_events;
+    ASSERT_EQ(num_events, 3);
+    ASSERT_NE(json.find("\"name\":\"thread\""), std::string::npos);
+    ASSERT_EQ(json.rfind("{\"traceEvents\":[", 0), 0);
+}
@@ -1,52 +1,117 @@
 #include "gtest/gtest.h"
 #include "../src/game.h"
 #include "../src/tree.h"
+#include <thread>
 
 
-TEST(TreeTest, Destruction) {
+TEST(TreeTest, Allocation) {
     int max_depth = 5;
-    int deleted_children;
+    Tree tree;
 
-    Tree* tree = new Tree();
-    Tree* leaf = tree;
+    Node* leaf = tree.get_root();
     for (int depth=0; depth<max_depth; ++depth) {
-        leaf = leaf->get_child(0);
+        leaf = tree.get_child(leaf, 0);
     }
-    
-    deleted_children = tree->delete_tree();
-    ASSERT_EQ(deleted_children, 12);
+    tree.get_child(tree.get_root(), 1);
+
+    ASSERT_EQ(tree.size(), 7);
+    ASSERT_EQ(tree.get_child(tree.get_root(), 0), tree.get_node(1));
+}
+
+TEST(TreeTest, ChunkBoundary) {
+    Tree tree;
+
+    Node* leaf = tree.get_root();
+    for (int depth=0; depth<2*Tree::CHUNK_SIZE; ++depth) {
+        leaf->set_regret(Cards::A, 0, static_cast<float>(depth));
+        leaf = tree.get_child(leaf, 0);
+    }
+
+    ASSERT_EQ(tree.size(), 2*Tree::CHUNK_SIZE + 1);
+    leaf = tree.get_root();
+    for (int depth=0; depth<2*Tree::CHUNK_SIZE; ++depth) {
+        ASSERT_EQ(leaf->get_regret(Cards::A, 0), static_cast<float>(depth));
+        leaf = tree.get_child(leaf, 0);
+    }
+}
+
+TEST(TreeTest, ActionOutOfRange) {
+    Tree tree;
+
+    ASSERT_DEATH(tree.get_child(tree.get_root(), MAX_MOVES), "The node has room for the action.");
+}
+
+TEST(TreeTest, Clear) {
+    Tree tree;
+    tree.get_child(tree.get_root(), 0)->set_regret(Cards::K, 1, 1.0f);
+    tree.get_root()->set_strategy(Cards::K, 1, 2.0f);
+
+    tree.clear();
+
+    ASSERT_EQ(tree.size(), 1);
+    ASSERT_EQ(tree.get_root()->get_strategy(Cards::K, 1), 0.0f);
+    ASSERT_EQ(tree.get_root()->children[0], NO_CHILD);
+    ASSERT_EQ(tree.get_child(tree.get_root(), 0)->get_regret(Cards::K, 1), 0.0f);
 }
 
 TEST(TreeTest, RegretUpdate) {
-    Tree* tree = new Tree();
+    Tree tree;
 
-    tree->set_regret(Cards::K, Move::C, -1.0f);
+    tree.get_root()->set_regret(Cards::K, 1, -1.0f);
 
-    ASSERT_EQ(tree->get_regret(Cards::K, Move::C), -1.0f);
-    tree->delete_tree();
+    ASSERT_EQ(tree.get_root()->get_regret(Cards::K, 1), -1.0f);
+    ASSERT_EQ(tree.get_root()->get_regret(Cards::Q, 0), 0.0f);
 }
 
 
 TEST(TreeTest, StrategyUpdate) {
-    Tree* tree = new Tree();
+    Tree tree;
 
-    tree->set_strategy(Cards::K, Move::C, 2.0f);
+    tree.get_root()->set_strategy(Cards::K, 1, 2.0f);
 
-    ASSERT_EQ(tree->get_strategy(Cards::K, Move::C), 2.0f);
-    tree->delete_tree();
+    ASSERT_EQ(tree.get_root()->get_strategy(Cards::K, 1), 2.0f);
+    ASSERT_EQ(tree.get_root()->get_strategy(Cards::Q, 0), 0.0f);
 }
 
 TEST(TreeTest, ScopedUpdate) {
-    Tree* tree = new Tree();
+    Tree tree;
 
     {
-        Tree* leaf = tree->get_child(0);
-        leaf->set_strategy(Cards::K, Move::C, 2.0f);
-        leaf->set_regret(Cards::K, Move::C, 1.0f);
+        Node* leaf = tree.get_child(tree.get_root(), 0);
+        leaf->set_strategy(Cards::K, 1, 2.0f);
+        leaf->set_regret(Cards::K, 1, 1.0f);
     }
 
-    ASSERT_EQ(tree->get_child(0)->get_strategy(Cards::K, Move::C), 2.0f);
-    ASSERT_EQ(tree->get_child(0)->get_regret(Cards::K, Move::C), 1.0f);
-    tree->delete_tree();
+    ASSERT_EQ(tree.get_child(tree.get_root(), 0)->get_strategy(Cards::K, 1), 2.0f);
+    ASSERT_EQ(tree.get_child(tree.get_root(), 0)->get_regret(Cards::K, 1), 1.0f);
+}
+
+void build_full_tree(Tree& tree, Node* node, int depth, std::vector<Node*>& leaves) {
+    // A binary tree, whatever number of actions the nodes have room for.
+    if (depth == 0) {
+        leaves.push_back(node);
+        return;
+    }
+    for (int action=0; action<2; ++action)
+        build_full_tree(tree, tree.get_child(node, action), depth - 1, leaves);
 }
 
+TEST(TreeTest, ConcurrentGetChild) {
+    int num_threads = 8;
+    int max_depth = 12;
+    Tree tree;
+
+    std::vector<std::vector<Node*>> leaves(num_threads);
+    std::vector<std::thread> threads;
+    for (int thread=0; thread<num_threads; ++thread)
+        threads.emplace_back(build_full_tree, std::ref(tree), tree.get_root(), max_depth, std::ref(leaves[thread]));
+    for (std::thread& thread:threads)
+        thread.join();
+
+    // Every thread ends up with the same nodes, and the nodes of the threads that lost a race are reused.
+    ASSERT_EQ(tree.size(), (1 << (max_depth + 1)) - 1);
+    for (int thread=1; thread<num_threads; ++thread)
+        ASSERT_EQ(leaves[thread], leaves[0]);
+    tree.get_child(leaves[0][0], 0);
+    ASSERT_EQ(tree.size(), 1 << (max_depth + 1));
+}